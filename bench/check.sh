@@ -0,0 +1,146 @@
+#!/bin/bash
+#
+# check.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: lpzun
+#
+# A regression check: every search must reach the same thread states and
+# the same number of global states as the sparse forward search.
+#
+# USAGE:
+#	./check.sh <ecut> <gen_tts>
+#
+# For every model in MODELS below, regenerated from its fixed seed, the
+# output of --repr sparse is compared with that of every setting in
+# VARIANTS, and with that of --incremental on EDITS random edit scripts,
+# each against a sparse search of the edited model. --incremental must
+# also refuse the dump of a search stopped by --max-states. Exits 1 on the
+# first difference, which is printed.
+
+ECUT=${1:-bin/ecut}
+GEN=${2:-bin/gen_tts}
+DIR=${CHECK_DIR:-/tmp/fws-check}
+EDITS=${CHECK_EDITS:-8}
+
+# name S L density spawn-ratio contention seed n s
+MODELS=(
+	"tiny     3  3 1.5 0.10 0.5  1 2 2"
+	"small    4  6 2.0 0.10 0.5  7 3 2"
+	"nospawn  6  6 1.5 0.00 0.4  3 4 0"
+	"spawny   6  6 1.5 0.30 0.4 11 2 3"
+	"sparse1  8  8 1.0 0.10 0.3  5 3 1"
+	"sparse2  8  8 1.2 0.10 0.6 13 2 2"
+	"mixed    8  8 2.0 0.10 0.3  7 2 1"
+	"deep    10  6 1.3 0.05 0.8 17 3 2"
+	"wide    12 12 1.2 0.05 0.3  7 2 1"
+	"locals   3 20 1.4 0.10 0.4 19 3 1"
+	"locals2  2 40 1.3 0.05 0.4  9 2 1"
+	"shared  20  3 1.5 0.10 0.7 23 3 2"
+)
+
+# the settings compared with --repr sparse
+VARIANTS=(
+	"--repr dense"
+	"--repr packed"
+	"--repr symbolic"
+	"--procs 2"
+	"--procs 3"
+)
+
+mkdir -p "$DIR" || exit 1
+
+# the thread states and the number of global states a run printed
+reach() {
+	"$ECUT" --tts --reach-ts --statistic "$@" \
+		| grep -E '^[0-9]+\|[0-9]+$|Thread States|Global States'
+	return ${PIPESTATUS[0]}
+}
+
+# compare the runs of $1 and $2, both files, for the case named $3
+same() {
+	if ! cmp -s "$1" "$2"; then
+		echo "FAILED: $3"
+		diff "$1" "$2" | head -20
+		exit 1
+	fi
+}
+
+# an edit script of 1 to 4 random edits of model $1 from seed $2 into $3,
+# and the edited model into $4
+edit() {
+	awk -v seed=$2 -v script="$3" 'NR == 1 {
+		S = $1; L = $2; print; next
+	}
+	NF >= 5 {
+		t[++m] = $1 " " $2 " " $3 " " $4 " " $5
+		key[$1 " " $2 " " $4 " " $5] = m
+	}
+	END {
+		srand(seed)
+		k = 1 + int(rand() * 4)
+		for (i = 0; i < k; ++i) {
+			if (rand() < 0.5 && m > 0) {
+				j = 1 + int(rand() * m)
+				if (t[j] == "")
+					continue
+				print "- " t[j] > script
+				split(t[j], f, " ")
+				delete key[f[1] " " f[2] " " f[4] " " f[5]]
+				t[j] = ""
+			} else {
+				s = int(rand() * S); l = int(rand() * L)
+				_s = int(rand() * S); _l = int(rand() * L)
+				if ((s " " l " " _s " " _l) in key)
+					continue
+				t[++m] = s " " l " " (rand() < 1 / 3 ? "+>" : "->") " " _s " " _l
+				key[s " " l " " _s " " _l] = m
+				print "+ " t[m] > script
+			}
+		}
+		for (j = 1; j <= m; ++j)
+			if (t[j] != "")
+				print t[j]
+	}' "$1" > "$4"
+	touch "$3"
+}
+
+ncases=0
+for model in "${MODELS[@]}"; do
+	set -- $model
+	name=$1 n=$8 s=$9
+	tts="$DIR/$name.tts"
+	"$GEN" -S $2 -L $3 -d $4 -p $5 -c $6 -r $7 -o "$tts" || exit 1
+	reach -f "$tts" -n $n -s $s --repr sparse --dump-states "$DIR/old.bin" \
+		> "$DIR/sparse.out" || exit 1
+	for variant in "${VARIANTS[@]}"; do
+		reach -f "$tts" -n $n -s $s $variant > "$DIR/variant.out" || exit 1
+		same "$DIR/sparse.out" "$DIR/variant.out" "$name n=$n s=$s $variant"
+		ncases=$((ncases + 1))
+	done
+	for ((e = 1; e <= EDITS; ++e)); do
+		rm -f "$DIR/edits.txt"
+		edit "$tts" $e "$DIR/edits.txt" "$DIR/new.tts"
+		reach -f "$DIR/new.tts" -n $n -s $s --repr sparse > "$DIR/sparse.out" \
+			|| exit 1
+		reach -f "$tts" --incremental "$DIR/old.bin" --edits "$DIR/edits.txt" \
+			> "$DIR/variant.out" || exit 1
+		same "$DIR/sparse.out" "$DIR/variant.out" \
+			"$name n=$n s=$s --incremental with edit script $e:
+$(cat "$DIR/edits.txt")"
+		ncases=$((ncases + 1))
+	done
+	echo "$name n=$n s=$s: ok"
+done
+
+# the dump of a stopped search holds only some reachable states
+"$ECUT" -f "$DIR/small.tts" --tts -n 3 -s 2 --max-states 20 \
+	--dump-states "$DIR/partial.bin" > /dev/null
+: > "$DIR/edits.txt"
+if "$ECUT" -f "$DIR/small.tts" --tts --incremental "$DIR/partial.bin" \
+	--edits "$DIR/edits.txt" > /dev/null; then
+	echo "FAILED: --incremental read the dump of a stopped search"
+	exit 1
+fi
+ncases=$((ncases + 1))
+echo "all $ncases cases agree with --repr sparse"
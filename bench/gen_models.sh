@@ -0,0 +1,48 @@
+#!/bin/bash
+#
+# gen_models.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: lpzun
+#
+# Generate the models that commit messages and reviews quote timings on,
+# so that those numbers can be reproduced.
+#
+# USAGE:
+#	./gen_models.sh <gen_tts> <directory>
+#
+# Writes <directory>/<name>.tts for every model in MODELS below, and
+# chain.tts, a model gen_tts cannot draw: a counter of 10 shared states
+# that each thread advances once, so that its cutoff (11) grows with S.
+
+GEN=${1:-bin/gen_tts}
+MODELDIR=${2:-/tmp/fws-bench-models}
+
+# name S L density spawn-ratio contention seed
+MODELS=(
+	"w      12 12 1.2 0.05 0.3 7"
+	"a      16 16 1.5 0.05 0.3 7"
+	"wide40  4 40 1.3 0.05 0.4 9"
+)
+
+mkdir -p "$MODELDIR" || exit 1
+
+for model in "${MODELS[@]}"; do
+	set -- $model
+	"$GEN" -S $2 -L $3 -d $4 -p $5 -c $6 -r $7 -o "$MODELDIR/$1.tts" || exit 1
+	echo "$MODELDIR/$1.tts"
+done
+
+awk -v S=10 -v L=7 'BEGIN {
+	print S, L
+	for (i = 0; i + 1 < S; ++i)
+		print i, 0, "->", i + 1, 1
+	for (i = 0; i < S; ++i) {
+		print i, 1, "->", i, 2
+		print i, 2, "->", i, 3
+		print i, 3, "+>", i, 4
+		print i, 4, "->", i, 5
+		print i, 5, "->", i, 6
+	}
+}' > "$MODELDIR/chain.tts" || exit 1
+echo "$MODELDIR/chain.tts"
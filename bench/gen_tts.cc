@@ -0,0 +1,131 @@
+/*
+ * gen_tts.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ *
+ * A generator of synthetic thread transition systems (.tts) used by the
+ * benchmark harness. The generated model is fully determined by its
+ * parameters and the seed, so the same suite can be regenerated and the
+ * results diffed between builds.
+ */
+
+#include <random>
+
+#include "../src/heads.hh"
+#include "../src/input.hh"
+
+using namespace sura;
+
+/**
+ * @brief generate a random thread transition system
+ * @param S: number of shared states
+ * @param L: number of local  states
+ * @param density   : average number of outgoing transitions per thread state
+ * @param spawn     : fraction of transitions which are spawn transitions
+ * @param contention: probability that a transition writes the shared state
+ * @param seed      : seed of the random number generator
+ * @param out
+ *
+ * Tips: std::mt19937 instead of Random is used here on purpose: its output
+ *       sequence is fixed by the standard, so the benchmark models are the
+ *       same on every platform.
+ */
+void generate(cushort& S, cushort& L, const double& density,
+		const double& spawn, const double& contention, culong& seed,
+		ostream& out) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> coin(0.0, 1.0);
+	std::uniform_int_distribution<ushort> any_share(0, S - 1);
+	std::uniform_int_distribution<ushort> any_local(0, L - 1);
+
+	out << S << " " << L << "\n";
+	for (ushort s1 = 0; s1 < S; ++s1) {
+		for (ushort l1 = 0; l1 < L; ++l1) {
+			/// the out-degree is floor(density), plus one with probability
+			/// of the fractional part of density
+			uint degree = uint(density);
+			if (coin(rng) < density - degree)
+				++degree;
+			/// (0|0) must be able to move, otherwise nothing is reachable
+			if (s1 == 0 && l1 == 0 && degree == 0)
+				degree = 1;
+
+			set<std::pair<ushort, ushort>> succs;
+			for (uint i = 0, tries = 0; i < degree && tries < 8 * degree;
+					++tries) {
+				const ushort s2 = coin(rng) < contention ? any_share(rng) : s1;
+				const ushort l2 = any_local(rng);
+				const bool is_spawn = coin(rng) < spawn;
+				if (!is_spawn && s1 == s2 && l1 == l2) /// a useless self-loop
+					continue;
+				if (!succs.emplace(s2, l2).second) /// each (src, dst) only once
+					continue;
+				out << s1 << " " << l1 << (is_spawn ? " +> " : " -> ") << s2
+						<< " " << l2 << "\n";
+				++i;
+			}
+		}
+	}
+}
+
+/**
+ * @brief main function of the generator
+ * @param argc
+ * @param argv
+ * @return int
+ * 					 0: successful
+ */
+int main(const int argc, const char * const * const argv) {
+	try {
+		Input ins;
+		ins.add_argument("-S", "number of shared states", "", "4");
+		ins.add_argument("-L", "number of local states", "", "4");
+		ins.add_argument("-d",
+				"edge density: average out-degree of a thread state", "",
+				"2");
+		ins.add_argument("-p", "spawn ratio: fraction of spawn transitions",
+				"", "0.1");
+		ins.add_argument("-c",
+				"shared-state contention: probability a transition writes the shared state",
+				"", "0.5");
+		ins.add_argument("-r", "seed of the random number generator", "",
+				"0");
+		ins.add_argument("-o", "output file (\"-\" for stdout)", "", "-");
+
+		try {
+			ins.get_command_line(argc, argv);
+		} catch (Input::Help) {
+			return 0;
+		}
+
+		const long S = ins.arg2long("-S");
+		const long L = ins.arg2long("-L");
+		const double density = atof(ins.arg_value("-d").c_str());
+		const double spawn = atof(ins.arg_value("-p").c_str());
+		const double contention = atof(ins.arg_value("-c").c_str());
+		if (S < 1 || S > 65535 || L < 1 || L > 65535)
+			throw CONTROL::Error("S and L must be in [1, 65535]");
+		if (density < 0 || spawn < 0 || spawn > 1 || contention < 0
+				|| contention > 1)
+			throw CONTROL::Error("illegal density, spawn ratio or contention");
+
+		const string filename = ins.arg_value("-o");
+		if (filename == "-") {
+			generate(S, L, density, spawn, contention, ins.arg2long("-r"),
+					cout);
+		} else {
+			ofstream out(filename.c_str());
+			if (!out)
+				throw CONTROL::Error("cannot open " + filename);
+			generate(S, L, density, spawn, contention, ins.arg2long("-r"),
+					out);
+			out.close();
+		}
+		return 0;
+	} catch (const CONTROL::Error& error) {
+		error.print_exit();
+	} catch (...) {
+		CONTROL::Error("main: unknown exception occurred").print_exit();
+	}
+}
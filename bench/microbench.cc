@@ -0,0 +1,249 @@
+/*
+ * microbench.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ *
+ * Microbenchmarks of the state-space kernels. The inputs of every kernel
+ * are captured from a real forward search on the given model, so that the
+ * kernels are timed over the state distributions they see in practice.
+ * For each kernel, the time and the number of heap allocations per
+ * operation are reported.
+ */
+
+#include <chrono>
+#include <new>
+#include <random>
+
+#include "../src/state.hh"
+#include "../src/input.hh"
+#include "../src/fws.hh"
+
+using namespace sura;
+
+/// the number of heap allocations so far, see operator new below
+static ulong allocations = 0;
+
+void* operator new(std::size_t size) {
+	++allocations;
+	if (void* p = std::malloc(size == 0 ? 1 : size))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+/// keep the compiler from optimizing a result away
+template<typename T>
+inline void do_not_optimize(const T& value) {
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * @brief time a kernel: body(i) performs operation i of ops operations; the
+ *        whole batch is repeated until at least min_time seconds elapsed
+ * @param name
+ * @param ops  : number of operations in one batch
+ * @param body
+ * @param setup: called before every batch, not timed
+ */
+template<typename Body, typename Setup>
+void measure(const string& name, culong& ops, const Body& body,
+		const Setup& setup, const double& min_time = 0.2) {
+	typedef std::chrono::steady_clock clock;
+	ulong total = 0, allocs = 0;
+	double elapsed = 0;
+	do {
+		setup();
+		const ulong start_allocs = allocations;
+		const auto start = clock::now();
+		for (ulong i = 0; i < ops; ++i)
+			body(i);
+		elapsed += std::chrono::duration<double>(clock::now() - start).count();
+		allocs += allocations - start_allocs;
+		total += ops;
+	} while (elapsed < min_time);
+
+	cout << PPRINT::widthify(name, 24, PPRINT::LEFTJUST)
+			<< PPRINT::widthify(total, 12, PPRINT::RIGHTJUST)
+			<< PPRINT::widthify(
+					PPRINT::formatString(1e9 * elapsed / total, "%.1f", 32), 12,
+					PPRINT::RIGHTJUST)
+			<< PPRINT::widthify(
+					PPRINT::formatString(double(allocs) / total, "%.2f", 32), 12,
+					PPRINT::RIGHTJUST) << endl;
+}
+
+template<typename Body>
+void measure(const string& name, culong& ops, const Body& body) {
+	measure(name, ops, body, [] {});
+}
+
+/**
+ * @brief main function of the microbenchmarks
+ * @param argc
+ * @param argv
+ * @return int
+ * 					 0: successful
+ */
+int main(const int argc, const char * const * const argv) {
+	try {
+		Input ins;
+		ins.add_argument("-f", "input file in .tts format", "", "X");
+		ins.add_argument("-n", "number of threads at the initial state", "",
+				"3");
+		ins.add_argument("-s", "maximum times of spawn transitions fired", "",
+				"2");
+		ins.add_argument("-i", "the initial thread state", "", "0|0");
+		ins.add_argument("-r", "seed used to sample the captured states", "",
+				"0");
+		try {
+			ins.get_command_line(argc, argv);
+		} catch (Input::Help) {
+			return 0;
+		}
+
+		const string filename = ins.arg_value("-f");
+		if (filename == "X")
+			throw CONTROL::Error("no input file");
+		const Thread_State init_ts = Util::create_thread_state_from_str(
+				ins.arg_value("-i"));
+		const adjacency_list TTD = Util::read_TTD(filename);
+		const Model model(Thread_State::S, Thread_State::L, TTD,
+				Refs::spawntra_TTD);
+		FWS fws(init_ts, model);
+
+		/// capture the reachable states of a real run
+		const auto store = fws.standard_FWS<size_p>(ins.arg2long("-n"),
+				ins.arg2long("-s"));
+		const auto& R = store.states();
+		if (R.empty())
+			throw CONTROL::Error("no state is reachable under this setting");
+		vector<Global_State> states(R.begin(), R.end());
+		std::mt19937 rng(ins.arg2long("-r"));
+		std::shuffle(states.begin(), states.end(), rng);
+
+		/// all transitions enabled in captured states, in expansion order
+		struct Firing {
+			const Global_State* tau;
+			Thread_State src;
+			Thread_State dst;
+			bool is_spawn;
+		};
+		vector<Firing> firings;
+		for (const auto& tau : states) {
+			for (const auto& loc : tau.locals) {
+				Thread_State src(tau.share, loc.first);
+				auto ifind = TTD.find(src);
+				if (ifind == TTD.end())
+					continue;
+				for (const auto& dst : ifind->second)
+					firings.push_back(
+							{ &tau, src, dst, Util::is_spawn_transition(src,
+									dst) });
+			}
+		}
+
+		cout << "model " << filename << ": " << states.size()
+				<< " captured states, " << firings.size()
+				<< " enabled transitions\n";
+		cout << PPRINT::widthify("kernel", 24, PPRINT::LEFTJUST)
+				<< PPRINT::widthify("ops", 12, PPRINT::RIGHTJUST)
+				<< PPRINT::widthify("ns/op", 12, PPRINT::RIGHTJUST)
+				<< PPRINT::widthify("allocs/op", 12, PPRINT::RIGHTJUST) << endl;
+
+		/// compare a state with its successor in sorted order (the common
+		/// case inside the visited set) and with a random state
+		vector<Global_State> sorted(R.begin(), R.end());
+		measure("compare_map", states.size(), [&](culong& i) {
+			const auto& s1 = sorted[i].locals;
+			const auto& s2 = (i % 2 == 0) ?
+					sorted[(i + 1) % sorted.size()].locals : states[i].locals;
+			do_not_optimize(COMPARE::compare_map(s1, s2));
+		});
+
+		if (!firings.empty()) {
+			measure("update_counter", firings.size(), [&](culong& i) {
+				const auto& f = firings[i];
+				auto Z = FWS::update_counter(f.tau->locals, f.src.local,
+						f.dst.local, f.is_spawn);
+				do_not_optimize(Z);
+			});
+
+			measure("is_spawn_transition", firings.size(), [&](culong& i) {
+				do_not_optimize(
+						Util::is_spawn_transition(firings[i].src,
+								firings[i].dst));
+			});
+		}
+
+		/// every batch inserts the captured states, in random order, into an
+		/// empty visited set; as in the search, an insertion copies the state
+		{
+			set<Global_State> visited;
+			measure("visited_insert", states.size(), [&](culong& i) {
+				do_not_optimize(visited.insert(states[i]).second);
+			}, [&] {visited.clear();});
+		}
+
+		measure("extract_reachable_TS", 1, [&](culong&) {
+			auto mark_R = fws.extract_reachable_TS(store);
+			do_not_optimize(mark_R);
+		});
+
+		/// the same kernels on dense states, if the captured states fit
+		typedef Dense_State<uint8_t, 64> Dense;
+		if (model.L() <= 64
+				&& ins.arg2long("-n") + ins.arg2long("-s") <= UINT8_MAX) {
+			vector<Dense> dense(states.size());
+			for (size_t i = 0; i < states.size(); ++i) {
+				dense[i].share = states[i].share;
+				for (const auto& p : states[i].locals)
+					dense[i].counters[p.first] = p.second;
+			}
+			measure("dense_compare", dense.size(), [&](culong& i) {
+				do_not_optimize(dense[i] == dense[(i + 1) % dense.size()]);
+			});
+			const Zobrist zobrist(model.S(), model.L(),
+					ins.arg2long("-n") + ins.arg2long("-s"));
+			vector<uint64_t> hashes(dense.size());
+			measure("zobrist_hash", dense.size(), [&](culong& i) {
+				hashes[i] = zobrist.hash(dense[i]);
+				do_not_optimize(hashes[i]);
+			});
+			if (!firings.empty()) {
+				measure("dense_update", firings.size(), [&](culong& i) {
+					const auto& f = firings[i];
+					Dense d = dense[(f.tau - states.data())];
+					d.update(f.src.local, f.dst.local, f.is_spawn);
+					do_not_optimize(d);
+				});
+				measure("zobrist_successor", firings.size(), [&](culong& i) {
+					const auto& f = firings[i];
+					const auto k = f.tau - states.data();
+					const auto& d = dense[k];
+					do_not_optimize(
+							zobrist.successor(hashes[k], d.share, f.dst.share,
+									f.src.local, d.counters[f.src.local],
+									f.dst.local, d.counters[f.dst.local],
+									f.is_spawn));
+				});
+			}
+			unique_ptr<Dense_Set<uint8_t, 64>> visited;
+			measure("dense_insert", dense.size(), [&](culong& i) {
+				do_not_optimize(visited->insert(dense[i], hashes[i]));
+			}, [&] {visited.reset(new Dense_Set<uint8_t, 64>());});
+		}
+		return 0;
+	} catch (const CONTROL::Error& error) {
+		error.print_exit();
+	} catch (...) {
+		CONTROL::Error("main: unknown exception occurred").print_exit();
+	}
+}
@@ -0,0 +1,70 @@
+#!/bin/bash
+#
+# run_bench.sh
+#
+#  Created on: Oct 19, 2026
+#      Author: lpzun
+#
+# Run the fixed benchmark suite and record the results in a tab-separated
+# file, one line per (model, n, s), so that two builds can be compared by
+# diffing their result files.
+#
+# USAGE:
+#	./run_bench.sh <ecut> <gen_tts> <result file>
+#
+# The models are regenerated from fixed seeds on every run; the suite is
+# the cross product of MODELS and SETTINGS below.
+
+ECUT=${1:-bin/ecut}
+GEN=${2:-bin/gen_tts}
+OUT=${3:-bench/results.tsv}
+MODELDIR=${BENCH_MODELS:-/tmp/fws-bench-models}
+
+# name S L density spawn-ratio contention seed
+MODELS=(
+	"small   4  6 2.0 0.10 0.5 7"
+	"mixed   8  8 2.0 0.10 0.3 7"
+	"wide   12 12 1.2 0.05 0.3 7"
+	"spawny  6  6 1.5 0.30 0.4 11"
+)
+
+# n s
+SETTINGS=(
+	"2 1"
+	"3 2"
+	"4 2"
+)
+
+mkdir -p "$MODELDIR" || exit 1
+
+# wall time in nanoseconds
+now() {
+	date +%s%N
+}
+
+printf "model\tS\tL\tdensity\tspawn\tcontention\tseed\tn\ts\tstates\twall_s\tstates_per_s\tpeak_rss_kb\n" > "$OUT"
+for model in "${MODELS[@]}"; do
+	set -- $model
+	name=$1 S=$2 L=$3 density=$4 spawn=$5 contention=$6 seed=$7
+	tts="$MODELDIR/$name.tts"
+	"$GEN" -S $S -L $L -d $density -p $spawn -c $contention -r $seed -o "$tts" || exit 1
+	for setting in "${SETTINGS[@]}"; do
+		set -- $setting
+		n=$1 s=$2
+		start=$(now)
+		log=$("$ECUT" -f "$tts" --tts -n $n -s $s --statistic) || exit 1
+		stop=$(now)
+		states=$(echo "$log" | sed -n 's/.*reachable Global States: *\([0-9]*\).*/\1/p')
+		rss=$(echo "$log" | sed -n 's/peak memory usage (KB): *\([0-9]*\).*/\1/p')
+		awk -v name=$name -v S=$S -v L=$L -v d=$density -v p=$spawn \
+			-v c=$contention -v seed=$seed -v n=$n -v s=$s -v states=$states \
+			-v ns=$((stop - start)) -v rss=$rss 'BEGIN {
+				wall = ns / 1e9
+				printf "%s\t%d\t%d\t%s\t%s\t%s\t%d\t%d\t%d\t%d\t%.3f\t%.0f\t%d\n",
+					name, S, L, d, p, c, seed, n, s, states, wall,
+					(wall > 0 ? states / wall : 0), rss
+			}' >> "$OUT"
+		echo "$name n=$n s=$s: $states states"
+	done
+done
+echo "results written to $OUT"
@@ -17,6 +17,9 @@
 #include <algorithm>
 #include <utility>
 
+#include <sys/resource.h>
+#include <unistd.h>
+
 #include "algs.hh"
 
 namespace sura {
@@ -74,6 +77,34 @@ bool wait_yes_no(const string& message, ostream& out) {
 
 ulong Timing::stamp;
 
+/**
+ * @brief the peak resident set size of this process
+ * @return ulong: in KB
+ */
+ulong Memory::peak_rss() {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024; // bytes on Mac OS X
+#else
+	return usage.ru_maxrss;
+#endif
+}
+
+/**
+ * @brief the current resident set size of this process. Where /proc is not
+ *        available, the peak resident set size is returned instead
+ * @return ulong: in KB
+ */
+ulong Memory::current_rss() {
+	std::ifstream statm("/proc/self/statm");
+	ulong size = 0, resident = 0;
+	if (statm >> size >> resident)
+		return resident * (sysconf(_SC_PAGESIZE) / 1024);
+	return peak_rss();
+}
+
 namespace COMPARE {
 short compare(clong& x, clong& y) {
 	if (x < y)
@@ -83,37 +114,6 @@ short compare(clong& x, clong& y) {
 	return 0;
 }
 
-/**
- * @brief compare maps
- * @param m1
- * @param m2
- */
-short compare_map(const map<ushort, ushort>& m1, const map<ushort, ushort>& m2) {
-	auto s1_iter = m1.begin(), s1_end = m1.end();
-	auto s2_iter = m2.begin(), s2_end = m2.end();
-	while (true) {
-		if (s1_iter == s1_end && s2_iter == s2_end) {
-			return 0;
-		} else if (s1_iter == s1_end) {
-			return -1;
-		} else if (s2_iter == s2_end) {
-			return 1;
-		} else if (s1_iter->first < s2_iter->first) {
-			return -1;
-		} else if (s1_iter->first > s2_iter->first) {
-			return 1;
-		} else if (s1_iter->first == s2_iter->first) {
-			if (s1_iter->second < s2_iter->second) {
-				return -1;
-			} else if (s1_iter->second > s2_iter->second) {
-				return 1;
-			}
-		}
-		s1_iter++, s2_iter++;
-	}
-	throw CONTROL::Error("COMPARE::compare: internal");
-}
-
 ulong string2num(const string& s) {
 	ulong l = atol(s.c_str());
 	if (PPRINT::widthify(l) != s) // we intepret this as error
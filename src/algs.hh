@@ -145,6 +145,12 @@ public:
 	}
 };
 
+class Memory {
+public:
+	static ulong peak_rss();    // peak resident set size of this process, in KB
+	static ulong current_rss(); // current resident set size of this process, in KB
+};
+
 // Evaluate assertion if __SAFE_COMPUTATION__ is defined. If not, __SAFE_ASSERT__ results in an empty statement ";"
 // Careful: in macro definition, NO SPACE between macro name and formal arg list!
 #ifdef __SAFE_COMPUTATION__
@@ -194,7 +200,32 @@ short compare_container(const T& x, const T& y) {
  * @param m1
  * @param m2
  */
-short compare_map(const map<ushort, ushort>& m1, const map<ushort, ushort>& m2);
+template<typename K, typename V>
+short compare_map(const map<K, V>& m1, const map<K, V>& m2) {
+	auto s1_iter = m1.begin(), s1_end = m1.end();
+	auto s2_iter = m2.begin(), s2_end = m2.end();
+	while (true) {
+		if (s1_iter == s1_end && s2_iter == s2_end) {
+			return 0;
+		} else if (s1_iter == s1_end) {
+			return -1;
+		} else if (s2_iter == s2_end) {
+			return 1;
+		} else if (s1_iter->first < s2_iter->first) {
+			return -1;
+		} else if (s1_iter->first > s2_iter->first) {
+			return 1;
+		} else if (s1_iter->first == s2_iter->first) {
+			if (s1_iter->second < s2_iter->second) {
+				return -1;
+			} else if (s1_iter->second > s2_iter->second) {
+				return 1;
+			}
+		}
+		s1_iter++, s2_iter++;
+	}
+	throw CONTROL::Error("COMPARE::compare: internal");
+}
 
 struct No_Number {
 };
@@ -309,7 +340,7 @@ string formatString(const T& x, const string& format, cushort& length = 10) {
 	char* s = new char[length];
 	snprintf(s, length, format.c_str(), x);
 	string result = s;
-	delete s;
+	delete[] s;
 	return result;
 }
 
@@ -0,0 +1,145 @@
+/*
+ * batch.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "batch.hh"
+#include "refs.hh"
+#include "fws.hh"
+
+namespace sura {
+
+Batch::Batch(const Engine& engine, culong& max_mem) :
+		engine(engine), max_mem(max_mem), nsearches(0), nseeded(0) {
+}
+
+/**
+ * @brief read queries, one per line: <initial thread state> <n> <s>, e.g.,
+ *        "0|0 3 2". "#" starts a comment
+ * @param in
+ * @return the queries in the order of the input
+ */
+vector<Query> Batch::read_queries(istream& in) {
+	std::stringstream no_comment;
+	CONTROL::remove_comments(in, no_comment, "#");
+	vector<Query> queries;
+	string init;
+	long n, s;
+	while (no_comment >> init) {
+		if (!(no_comment >> n >> s) || n < 0 || s < 0)
+			throw CONTROL::Error("illegal query for initial state " + init);
+		counter_width(n + s); /// throws if no counter holds n + s
+		queries.emplace_back(Util::create_thread_state_from_str(init), n, s);
+	}
+	return queries;
+}
+
+/**
+ * @brief can the answer to query small be reused by query large? Every run
+ *        of small is a run of large: the extra threads stay idle at the
+ *        initial state, and the run fires at most small.s <= large.s spawn
+ *        transitions.
+ * @param small
+ * @param large
+ * @return bool
+ */
+bool Batch::is_monotonic(const Query& small, const Query& large) const {
+	return small.init == large.init && small.n <= large.n
+			&& small.s <= large.s;
+}
+
+/**
+ * @brief the states to start the search of q from: the largest seed of an
+ *        answered query whose runs are runs of q
+ * @param q
+ * @return the seed, or nullptr if there is none
+ */
+const Seed* Batch::seed(const Query& q) const {
+	const Seed* best = nullptr;
+	for (const auto& c : seeds)
+		if (this->is_monotonic(c.query, q)
+				&& (best == nullptr || c.states.size() > best->states.size()))
+			best = &c;
+	return best;
+}
+
+/**
+ * @brief answer one query, from the cache if possible
+ * @param q
+ * @return Result
+ */
+const Result& Batch::query(const Query& q) {
+	const Key key(q.init, q.n, q.s);
+	auto icache = cache.find(key);
+	if (icache != cache.end())
+		return icache->second;
+	const Seed* from = this->seed(q);
+	Seed to;
+	++nsearches;
+	if (from != nullptr)
+		++nseeded;
+	const Result r = engine.query(q, max_mem, from, &to);
+	if (!to.states.empty()) { /// a seed q dominates is of no more use
+		seeds.erase(
+				std::remove_if(seeds.begin(), seeds.end(),
+						[&](const Seed& c) {
+							return this->is_monotonic(c.query, q);
+						}), seeds.end());
+		seeds.emplace_back(std::move(to));
+	}
+	return cache.emplace(key, r).first->second;
+}
+
+/**
+ * @brief answer all queries, smaller bounds first, and print the answers in
+ *        the order of the input
+ * @param queries
+ * @param out
+ */
+void Batch::run(const vector<Query>& queries, ostream& out) {
+	vector<Query> order(queries);
+	std::sort(order.begin(), order.end(), [](const Query& a, const Query& b) {
+		return std::make_tuple(a.init, a.n, a.s) < std::make_tuple(b.init, b.n, b.s);
+	});
+	for (const auto& q : order)
+		this->query(q);
+
+	const auto& model = engine.model();
+	for (const auto& q : queries) {
+		const Result& r = this->query(q);
+		uint reach = 0;
+		for (size_s s = 0; s < model.S(); ++s)
+			for (size_l l = 0; l < model.L(); ++l)
+				if (r.reachable[s][l])
+					++reach;
+		out << q.init.share << "|" << q.init.local << " " << q.n << " " << q.s
+				<< ": " << reach << " of " << model.S() * model.L()
+				<< " thread states reachable, " << r.states
+				<< " global states" << (r.exact ? "" : " (approximate)")
+				<< "\n";
+		for (const auto& note : r.notes)
+			out << "  " << note << "\n";
+		if (Refs::OPT_PRT_REACH_TS) {
+			out << "  reachable:";
+			for (size_s s = 0; s < model.S(); ++s)
+				for (size_l l = 0; l < model.L(); ++l)
+					if (r.reachable[s][l])
+						out << " " << s << "|" << l;
+			out << "\n";
+		}
+		if (Refs::OPT_PRT_UNREACH_TS) {
+			out << "  unreachable:";
+			for (size_s s = 0; s < model.S(); ++s)
+				for (size_l l = 0; l < model.L(); ++l)
+					if (!r.reachable[s][l])
+						out << " " << s << "|" << l;
+			out << "\n";
+		}
+	}
+	out << queries.size() << " queries answered by " << nsearches
+			<< " searches, " << nseeded << " of them seeded" << endl;
+}
+
+} /* namespace sura */
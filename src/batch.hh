@@ -0,0 +1,62 @@
+/*
+ * batch.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef BATCH_HH_
+#define BATCH_HH_
+
+#include <tuple>
+
+#include "engine.hh"
+
+namespace sura {
+
+/**
+ * @brief answer a file of queries on one model. Queries run in order of
+ *        their bounds, smaller first; every answer is cached by
+ *        (initial state, n, s), so duplicate queries are free. A reachable
+ *        global state under smaller bounds, padded with idle threads at the
+ *        initial state, is one under larger bounds, so the search of a
+ *        larger query starts from the reachable states of a smaller one and
+ *        expands again only those of them whose extra threads or spawns can
+ *        move, see FWS::set_seed. The answers are exact.
+ */
+class Batch {
+public:
+	typedef std::tuple<Thread_State, size_p, size_p> Key;
+
+	explicit Batch(const Engine& engine, culong& max_mem = 0);
+	~Batch() {
+	}
+
+	static vector<Query> read_queries(istream& in);
+
+	void run(const vector<Query>& queries, ostream& out = cout);
+	const Result& query(const Query& q);
+
+	inline ulong searches() const {
+		return nsearches;
+	}
+	/// the searches that started from the states of a smaller query
+	inline ulong seeded() const {
+		return nseeded;
+	}
+
+private:
+	const Engine& engine;
+	ulong max_mem;
+	map<Key, Result> cache;
+	vector<Seed> seeds; /// of the answered queries no other one dominates
+	ulong nsearches;
+	ulong nseeded;
+
+	bool is_monotonic(const Query& small, const Query& large) const;
+	const Seed* seed(const Query& q) const;
+};
+
+} /* namespace sura */
+
+#endif /* BATCH_HH_ */
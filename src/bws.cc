@@ -0,0 +1,139 @@
+/*
+ * bws.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "bws.hh"
+
+namespace sura {
+
+/**
+ * @brief index the transitions of the model by their destination shared
+ *        state, the only one a predecessor computation looks up
+ * @param model
+ */
+BWS::BWS(const Model& model) :
+		model(model), into(model.S()), alive(0), npre(0) {
+	for (size_s s = 0; s < model.S(); ++s)
+		for (size_l l = 0; l < model.L(); ++l)
+			for (const auto& e : model.successors(Thread_State(s, l)))
+				into[e.dst.share].emplace_back(Thread_State(s, l),
+						e.dst.local, e.is_spawn);
+}
+
+/**
+ * @brief the backward search: is target coverable from any number of threads
+ *        at init, with any number of spawn transitions?
+ * @param init  : the initial thread state
+ * @param target: the thread state to cover
+ * @return the smallest number of threads at init that covers target, or 0
+ *         if no number of threads does
+ */
+size_p BWS::cover(const Thread_State& init, const Thread_State& target) {
+	if (!model.contains(init) || !model.contains(target))
+		throw CONTROL::Error("thread state out of range");
+	pool.clear();
+	antichain.assign(model.S(), vector<ulong>());
+	alive = 0;
+	npre = 0;
+
+	vector<size_p> counters(model.L(), 0);
+	counters[target.local] = 1;
+	this->insert(target.share, counters);
+	/// the pool is the worklist: its elements are expanded in the order they
+	/// were found, except those replaced by a smaller one meanwhile, whose
+	/// predecessors are covered by those of the smaller one
+	for (ulong next = 0; next < pool.size(); ++next) {
+		if (!pool[next].is_alive)
+			continue;
+		/// copy: insert may reallocate the pool, or replace this element
+		const Shared_State _s = pool[next].share;
+		const vector<size_p> v(pool[next].counters);
+		for (const auto& t : into[_s]) {
+			++npre;
+			vector<size_p> u(v);
+			/// the thread that entered dst may be one of those required
+			if (u[t.dst] > 0)
+				--u[t.dst];
+			if (t.is_spawn) { /// the spawner stays at src.local
+				if (u[t.src.local] == 0)
+					u[t.src.local] = 1;
+			} else {
+				++u[t.src.local];
+			}
+			this->insert(t.src.share, u);
+		}
+	}
+
+	size_p n = 0;
+	for (const auto& m : pool) {
+		if (!m.is_alive)
+			continue;
+		const auto k = this->threads(init, m);
+		if (k > 0 && (n == 0 || k < n))
+			n = k;
+	}
+	return n;
+}
+
+/**
+ * @brief add a minimal element unless it covers one of the antichain, and
+ *        drop the elements that cover it
+ * @param s
+ * @param counters
+ * @return false if counters covers an element of the antichain
+ */
+bool BWS::insert(const Shared_State& s, const vector<size_p>& counters) {
+	auto& bucket = antichain[s];
+	for (const auto& i : bucket)
+		if (covers(counters, pool[i].counters))
+			return false;
+	size_t k = 0;
+	for (size_t j = 0; j < bucket.size(); ++j) {
+		if (covers(pool[bucket[j]].counters, counters)) {
+			/// its counters are never read again
+			pool[bucket[j]].is_alive = false;
+			vector<size_p>().swap(pool[bucket[j]].counters);
+			--alive;
+		} else {
+			bucket[k++] = bucket[j];
+		}
+	}
+	bucket.resize(k);
+	bucket.emplace_back(pool.size());
+	pool.emplace_back(s, counters);
+	++alive;
+	return true;
+}
+
+/**
+ * @brief the number of threads at init whose initial state is covered by m
+ * @param init
+ * @param m
+ * @return the smallest such number, or 0 if there is none
+ */
+size_p BWS::threads(const Thread_State& init, const Minimal& m) const {
+	if (m.share != init.share)
+		return 0;
+	for (size_l l = 0; l < model.L(); ++l)
+		if (l != init.local && m.counters[l] > 0)
+			return 0;
+	return std::max(m.counters[init.local], size_p(1));
+}
+
+/**
+ * @brief does a cover b, i.e., is every counter of a at least that of b?
+ * @param a
+ * @param b
+ * @return bool
+ */
+bool BWS::covers(const vector<size_p>& a, const vector<size_p>& b) {
+	for (size_t l = 0; l < a.size(); ++l)
+		if (a[l] < b[l])
+			return false;
+	return true;
+}
+
+} /* namespace sura */
@@ -0,0 +1,91 @@
+/*
+ * bws.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef BWS_HH_
+#define BWS_HH_
+
+#include "model.hh"
+
+namespace sura {
+
+/**
+ * @brief a backward search for coverability. A thread state (s,l) is
+ *        coverable if a global state with shared state s and a thread at l
+ *        is reachable from some number of threads at the initial thread
+ *        state, with any number of spawn transitions. The states covering a
+ *        target form an upward-closed set, represented by its minimal
+ *        elements: the search adds the minimal predecessors of every new
+ *        minimal element, and keeps an antichain by dropping an element that
+ *        covers another one. Global states are well-quasi-ordered by
+ *        covering, so the antichain stabilizes after finitely many steps,
+ *        whatever the number of threads; its memory is that of the
+ *        antichain, not of the reachable state space.
+ */
+class BWS {
+public:
+	explicit BWS(const Model& model);
+	~BWS() {
+	}
+
+	size_p cover(const Thread_State& init, const Thread_State& target);
+
+	/// the minimal elements of the last search
+	inline ulong antichain_size() const {
+		return alive;
+	}
+	/// the predecessors computed by the last search
+	inline ulong predecessors() const {
+		return npre;
+	}
+	/// the minimal elements found by the last search, including those that
+	/// were dropped later
+	inline ulong generated() const {
+		return pool.size();
+	}
+
+private:
+	/// a transition into a shared state: from src, a thread enters local
+	/// dst, or, if is_spawn, a thread at src.local spawns one at dst
+	struct Transition {
+		Thread_State src;
+		Local_State dst;
+		bool is_spawn;
+
+		Transition(const Thread_State& src, const Local_State& dst,
+				const bool& is_spawn) :
+				src(src), dst(dst), is_spawn(is_spawn) {
+		}
+	};
+
+	/// a minimal element: all states with this shared state and at least
+	/// these counters
+	struct Minimal {
+		Shared_State share;
+		vector<size_p> counters; /// indexed by local state
+		bool is_alive;           /// false once a smaller element replaced it
+
+		Minimal(const Shared_State& share, const vector<size_p>& counters) :
+				share(share), counters(counters), is_alive(true) {
+		}
+	};
+
+	const Model& model;
+	vector<vector<Transition>> into; /// indexed by destination shared state
+
+	vector<Minimal> pool;           /// every minimal element ever found
+	vector<vector<ulong>> antichain; /// per shared state: indices into pool
+	ulong alive;
+	ulong npre;
+
+	bool insert(const Shared_State& s, const vector<size_p>& counters);
+	size_p threads(const Thread_State& init, const Minimal& m) const;
+	static bool covers(const vector<size_p>& a, const vector<size_p>& b);
+};
+
+} /* namespace sura */
+
+#endif /* BWS_HH_ */
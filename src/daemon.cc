@@ -0,0 +1,544 @@
+/*
+ * daemon.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "daemon.hh"
+#include "fws.hh"
+
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace sura {
+
+namespace {
+
+/**
+ * @brief a UNIX-domain socket address
+ * @param path
+ * @return sockaddr_un
+ */
+sockaddr_un address(const string& path) {
+	sockaddr_un addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(addr.sun_path))
+		throw CONTROL::Error("socket path too long: " + path);
+	std::strcpy(addr.sun_path, path.c_str());
+	return addr;
+}
+
+/**
+ * @brief write all bytes of data to fd
+ * @param fd
+ * @param data
+ * @return false if the peer has gone
+ */
+bool write_all(const int& fd, const string& data) {
+	size_t done = 0;
+	while (done < data.size()) {
+		const ssize_t k = ::send(fd, data.data() + done, data.size() - done,
+				MSG_NOSIGNAL);
+		if (k < 0 && errno == EINTR)
+			continue;
+		if (k <= 0)
+			return false;
+		done += k;
+	}
+	return true;
+}
+
+/**
+ * @brief a buffered reader of lines and byte blocks from a socket
+ */
+class Reader {
+public:
+	explicit Reader(const int& fd) :
+			fd(fd) {
+	}
+
+	bool read_line(string& line) {
+		size_t eol;
+		while ((eol = buffer.find('\n')) == string::npos)
+			if (!this->fill())
+				return false;
+		line = buffer.substr(0, eol);
+		buffer.erase(0, eol + 1);
+		return true;
+	}
+
+	bool read_bytes(const size_t& n, string& data) {
+		while (buffer.size() < n)
+			if (!this->fill())
+				return false;
+		data = buffer.substr(0, n);
+		buffer.erase(0, n);
+		return true;
+	}
+
+private:
+	const int fd;
+	string buffer;
+
+	bool fill() {
+		char chunk[4096];
+		ssize_t k;
+		do {
+			k = ::recv(fd, chunk, sizeof(chunk), 0);
+		} while (k < 0 && errno == EINTR);
+		if (k <= 0)
+			return false;
+		buffer.append(chunk, k);
+		return true;
+	}
+};
+
+/**
+ * @brief the version of a file, see Daemon::Version
+ * @param path
+ * @return std::tuple<long, long, long, ulong>
+ */
+std::tuple<long, long, long, ulong> version(const string& path) {
+	struct stat st;
+	if (::stat(path.c_str(), &st) != 0)
+		throw CONTROL::Error("cannot open " + path);
+	return std::make_tuple(long(st.st_mtim.tv_sec), long(st.st_mtim.tv_nsec),
+			long(st.st_size), ulong(st.st_ino));
+}
+
+} /* namespace */
+
+/////////////////////// requests ////////////////////////////////
+
+/**
+ * @brief the request as one protocol line, without the newline
+ * @return string
+ */
+string Request::to_line() const {
+	std::ostringstream line;
+	line << "query\t" << model << "\t" << query.init.share << "|"
+			<< query.init.local << "\t" << query.n << "\t" << query.s << "\t"
+			<< max_mem << "\t" << prt_reach_ts << "\t" << prt_unreach_ts
+			<< "\t" << prt_statistic;
+	return line.str();
+}
+
+/**
+ * @brief parse a protocol line produced by to_line
+ * @param line
+ * @return Request
+ */
+Request Request::from_line(const string& line) {
+	const auto fields = Util::split(line, '\t');
+	if (fields.size() != 9 || fields[0] != "query")
+		throw CONTROL::Error("malformed request");
+	Request r;
+	r.model = fields[1];
+	r.query = Query(Util::create_thread_state_from_str(fields[2]),
+			atol(fields[3].c_str()), atol(fields[4].c_str()));
+	r.max_mem = atol(fields[5].c_str());
+	r.prt_reach_ts = fields[6] == "1";
+	r.prt_unreach_ts = fields[7] == "1";
+	r.prt_statistic = fields[8] == "1";
+	return r;
+}
+
+/////////////////////// daemon ////////////////////////////////
+
+/**
+ * @brief bind the socket; a stale socket file is replaced
+ * @param socket_path
+ * @param nthreads: the size of the thread pool (0: one per core)
+ */
+Daemon::Daemon(const string& socket_path, const uint& nthreads) :
+		socket_path(socket_path), nthreads(
+				nthreads > 0 ?
+						nthreads :
+						std::max(1u, std::thread::hardware_concurrency())), listen_fd(
+				-1), stopping(false) {
+	if (::pipe(wake) != 0)
+		throw CONTROL::Error("cannot create a pipe");
+	const sockaddr_un addr = address(socket_path);
+	listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listen_fd < 0)
+		throw CONTROL::Error("cannot create a socket");
+	::unlink(socket_path.c_str());
+	if (::bind(listen_fd, (const sockaddr*) &addr, sizeof(addr)) != 0
+			|| ::listen(listen_fd, SOMAXCONN) != 0) {
+		::close(listen_fd);
+		throw CONTROL::Error("cannot listen on " + socket_path);
+	}
+}
+
+Daemon::~Daemon() {
+	this->stop();
+	for (auto& w : workers)
+		if (w.joinable())
+			w.join();
+	if (listen_fd >= 0)
+		::close(listen_fd);
+	::close(wake[0]);
+	::close(wake[1]);
+	::unlink(socket_path.c_str());
+}
+
+/**
+ * @brief accept connections, and hand those with a request to the thread
+ *        pool, until a shutdown request arrives
+ */
+void Daemon::serve() {
+	cout << "listening on " << socket_path << " with " << nthreads
+			<< " threads" << endl;
+	for (uint i = 0; i < nthreads; ++i)
+		workers.emplace_back(&Daemon::work, this);
+	vector<Connection> idle; /// the connections polled
+	vector<pollfd> fds;
+	while (!stopping) {
+		{
+			std::lock_guard<std::mutex> lock(queue_mtx);
+			for (auto& c : served)
+				idle.emplace_back(std::move(c));
+			served.clear();
+		}
+		fds.assign(2, pollfd { 0, POLLIN, 0 });
+		fds[0].fd = listen_fd;
+		fds[1].fd = wake[0];
+		for (const auto& c : idle)
+			fds.emplace_back(pollfd { c.fd, POLLIN, 0 });
+		if (::poll(fds.data(), fds.size(), 1000) < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		if (fds[1].revents != 0) {
+			char drain[64];
+			while (::read(wake[0], drain, sizeof(drain)) == sizeof(drain))
+				;
+		}
+		const auto now = std::chrono::steady_clock::now();
+		vector<Connection> still;
+		for (size_t i = 0; i < idle.size(); ++i) {
+			if (fds[i + 2].revents != 0) {
+				std::lock_guard<std::mutex> lock(queue_mtx);
+				ready.emplace_back(std::move(idle[i]));
+				queue_cv.notify_one();
+			} else if (now - idle[i].last
+					> std::chrono::seconds(int(IDLE_SECONDS))) {
+				this->close(idle[i]);
+			} else {
+				still.emplace_back(std::move(idle[i]));
+			}
+		}
+		idle.swap(still);
+		if (fds[0].revents != 0) {
+			const int fd = ::accept(listen_fd, nullptr, nullptr);
+			if (fd < 0) {
+				if (errno == EINTR || errno == ECONNABORTED || errno == EAGAIN)
+					continue;
+				break;
+			}
+			std::lock_guard<std::mutex> lock(queue_mtx);
+			open.insert(fd);
+			idle.emplace_back(Connection { fd, "", now });
+		}
+	}
+	this->stop();
+	for (auto& w : workers)
+		w.join();
+	workers.clear();
+	for (const auto& c : idle)
+		this->close(c);
+	for (const auto& c : ready)
+		this->close(c);
+	for (const auto& c : served)
+		this->close(c);
+	ready.clear();
+	served.clear();
+}
+
+/**
+ * @brief stop accepting and serving: shut down every open connection, so
+ *        no client holds the daemon up. The workers finish the request at
+ *        hand, if any
+ */
+void Daemon::stop() {
+	std::lock_guard<std::mutex> lock(queue_mtx);
+	if (!stopping.exchange(true)) {
+		::shutdown(listen_fd, SHUT_RDWR);
+		for (const auto& fd : open)
+			::shutdown(fd, SHUT_RDWR);
+		this->wake_up();
+	}
+	queue_cv.notify_all();
+}
+
+/**
+ * @brief make the poll of serve return
+ */
+void Daemon::wake_up() {
+	const char c = 0;
+	if (::write(wake[1], &c, 1) < 0) {
+		/// the pipe is full, so serve wakes up anyway
+	}
+}
+
+/**
+ * @brief close a connection
+ * @param c
+ */
+void Daemon::close(const Connection& c) {
+	std::lock_guard<std::mutex> lock(queue_mtx);
+	open.erase(c.fd);
+	::close(c.fd);
+}
+
+/**
+ * @brief a worker of the thread pool: it serves the requests that arrived
+ *        on a connection, and hands the connection back to serve
+ */
+void Daemon::work() {
+	while (true) {
+		Connection c;
+		{
+			std::unique_lock<std::mutex> lock(queue_mtx);
+			queue_cv.wait(lock, [this] {
+				return stopping || !ready.empty();
+			});
+			if (stopping)
+				return;
+			c = std::move(ready.front());
+			ready.pop_front();
+		}
+		if (!this->handle(c)) {
+			this->close(c);
+			continue;
+		}
+		std::lock_guard<std::mutex> lock(queue_mtx);
+		served.emplace_back(std::move(c));
+		this->wake_up();
+	}
+}
+
+/**
+ * @brief read what arrived on a connection, without blocking, and answer
+ *        the requests it completes
+ * @param c
+ * @return false if the connection is to be closed
+ */
+bool Daemon::handle(Connection& c) {
+	char chunk[4096];
+	ssize_t k;
+	do {
+		k = ::recv(c.fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+	} while (k < 0 && errno == EINTR);
+	if (k == 0 || (k < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+		return false;
+	if (k > 0) {
+		c.buffer.append(chunk, k);
+		c.last = std::chrono::steady_clock::now();
+	}
+	size_t eol;
+	while ((eol = c.buffer.find('\n')) != string::npos) {
+		const string line = c.buffer.substr(0, eol);
+		c.buffer.erase(0, eol + 1);
+		if (line == "shutdown") {
+			write_all(c.fd, "ok 0\n");
+			this->stop();
+			return false;
+		}
+		if (!write_all(c.fd, this->answer(line)))
+			return false;
+		c.last = std::chrono::steady_clock::now(); /// idle from now on
+	}
+	return !stopping;
+}
+
+/**
+ * @brief the answer to one request line
+ * @param line
+ * @return string
+ */
+string Daemon::answer(const string& line) {
+	if (line == "ping")
+		return "ok 0\n";
+	try {
+		const string output = this->analyze(Request::from_line(line));
+		return "ok " + std::to_string(output.size()) + "\n" + output;
+	} catch (const CONTROL::Error& error) {
+		return "error " + error.message + "\n";
+	} catch (const std::exception& e) {
+		return string("error ") + e.what() + "\n";
+	}
+}
+
+/**
+ * @brief run an analysis, or take its result from the cache
+ * @param r
+ * @return the output of the analysis
+ */
+string Daemon::analyze(const Request& r) {
+	Version v;
+	const auto engine = this->engine(r.model, v);
+	const Key key(r.model, v, r.query.init, r.query.n, r.query.s, r.max_mem);
+	Result result;
+	bool cached = false;
+	{
+		std::lock_guard<std::mutex> lock(cache_mtx);
+		auto ires = results.find(key);
+		if (ires != results.end())
+			result = ires->second, cached = true;
+	}
+	if (!cached) {
+		result = engine->query(r.query, r.max_mem * 1024 * 1024);
+		std::lock_guard<std::mutex> lock(cache_mtx);
+		if (results.emplace(key, result).second) {
+			lru.push_back(key);
+			if (lru.size() > RESULT_CACHE) {
+				results.erase(lru.front());
+				lru.pop_front();
+			}
+		}
+	}
+	string output = render(engine->model(), r, result);
+	if (r.prt_statistic) /// that of the daemon, which ran the search
+		output += "peak memory usage (KB): "
+				+ std::to_string(Memory::peak_rss()) + "\n";
+	return output;
+}
+
+/**
+ * @brief the engine of a model, compiled at most once per version of its file
+ * @param path
+ * @param v   : the version of the file compiled
+ * @return the engine
+ */
+shared_ptr<const Engine> Daemon::engine(const string& path, Version& v) {
+	v = version(path);
+	{
+		std::lock_guard<std::mutex> lock(cache_mtx);
+		auto imodel = models.find(path);
+		if (imodel != models.end() && imodel->second.version == v)
+			return imodel->second.engine;
+	}
+	/// compile outside the lock: other models stay available meanwhile
+	auto engine = std::make_shared<const Engine>(path);
+	std::lock_guard<std::mutex> lock(cache_mtx);
+	models[path] = Entry { v, engine };
+	return engine;
+}
+
+/**
+ * @brief the output of FWS::reachability_analysis for a result
+ * @param model
+ * @param r
+ * @param result
+ * @return string
+ */
+string Daemon::render(const Model& model, const Request& r,
+		const Result& result) {
+	std::ostringstream out;
+	for (const auto& note : result.notes)
+		out << note << "\n";
+	if (r.prt_reach_ts) {
+		out << "Reachable Thread States:\n";
+		for (size_s s = 0; s < model.S(); ++s)
+			for (size_l l = 0; l < model.L(); ++l)
+				if (result.reachable[s][l])
+					out << s << "|" << l << "\n";
+		out << endl;
+	}
+	if (r.prt_unreach_ts) {
+		out << "Unreachable Thread States:\n";
+		for (size_s s = 0; s < model.S(); ++s)
+			for (size_l l = 0; l < model.L(); ++l)
+				if (!result.reachable[s][l])
+					out << s << "|" << l << "\n";
+		out << endl;
+	}
+	if (r.prt_statistic) {
+		uint reach = 0;
+		for (size_s s = 0; s < model.S(); ++s)
+			for (size_l l = 0; l < model.L(); ++l)
+				if (result.reachable[s][l])
+					++reach;
+		out << "current # of   reachable Global States: " << result.states
+				<< "\n";
+		out << "current # of   reachable Thread States: " << reach << "\n";
+		out << "current # of unreachable Thread States: "
+				<< (model.S() * model.L() - reach) << "\n";
+		out << endl;
+	}
+	if (r.max_mem > 0) {
+		if (result.exact)
+			out << "the result is exact (states stored as " << result.store
+					<< ")\n";
+		else
+			out << "the result is APPROXIMATE: bitstate storage may have "
+					"missed states, so the reachable thread states are an "
+					"under-approximation\n";
+		out << endl;
+	}
+	return out.str();
+}
+
+/////////////////////// client ////////////////////////////////
+
+/**
+ * @brief send a request to the daemon and print its answer
+ * @param socket_path
+ * @param r
+ * @param out
+ * @return false if no daemon listens on socket_path
+ */
+bool Client::query(const string& socket_path, const Request& r,
+		ostream& out) {
+	const sockaddr_un addr = address(socket_path);
+	const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return false;
+	if (::connect(fd, (const sockaddr*) &addr, sizeof(addr)) != 0) {
+		::close(fd);
+		return false;
+	}
+	Reader in(fd);
+	string status, output;
+	const bool ok = write_all(fd, r.to_line() + "\n") && in.read_line(status);
+	if (ok && status.compare(0, 3, "ok ") == 0
+			&& in.read_bytes(atol(status.c_str() + 3), output)) {
+		::close(fd);
+		out << output << std::flush;
+		return true;
+	}
+	::close(fd);
+	if (ok && status.compare(0, 6, "error ") == 0)
+		throw CONTROL::Error(status.substr(6));
+	throw CONTROL::Error("lost the connection to " + socket_path);
+}
+
+/**
+ * @brief ask the daemon to shut down
+ * @param socket_path
+ */
+void Client::shutdown(const string& socket_path) {
+	const sockaddr_un addr = address(socket_path);
+	const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0 || ::connect(fd, (const sockaddr*) &addr, sizeof(addr)) != 0) {
+		if (fd >= 0)
+			::close(fd);
+		throw CONTROL::Error("no daemon listens on " + socket_path);
+	}
+	Reader in(fd);
+	string status;
+	write_all(fd, "shutdown\n");
+	in.read_line(status);
+	::close(fd);
+}
+
+} /* namespace sura */
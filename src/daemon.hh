@@ -0,0 +1,136 @@
+/*
+ * daemon.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef DAEMON_HH_
+#define DAEMON_HH_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#include "engine.hh"
+
+namespace sura {
+
+/// a request to the daemon: one reachability analysis, and what to print
+struct Request {
+	string model; /// absolute path of the .tts file
+	Query query;
+	ulong max_mem; /// memory budget in MB (0: unlimited)
+	bool prt_reach_ts;
+	bool prt_unreach_ts;
+	bool prt_statistic;
+
+	Request() :
+			query(Thread_State(), 1, 0), max_mem(0), prt_reach_ts(false), prt_unreach_ts(
+					false), prt_statistic(false) {
+	}
+
+	string to_line() const;
+	static Request from_line(const string& line);
+};
+
+/**
+ * @brief a verification daemon. It listens on a UNIX-domain socket and keeps
+ *        the compiled models and the most recent results resident, so a
+ *        request pays neither process startup nor parsing. The protocol is
+ *        line based; a client sends one request per line:
+ *          query <model> <i> <n> <s> <max-mem> <reach-ts> <unreach-ts> <statistic>
+ *          ping
+ *          shutdown
+ *        fields separated by tabs, and the daemon answers either
+ *          ok <bytes>\n<the output of the analysis>
+ *        or
+ *          error <message>\n
+ *        A connection may carry any number of requests. The thread of serve
+ *        polls the connections and hands one whose request has arrived to a
+ *        fixed pool of threads, which answers it and hands the connection
+ *        back; so an idle connection holds no thread, and one idle for
+ *        IDLE_SECONDS since its last request or answer is closed. A model is
+ *        reloaded if its file has changed since it was compiled. With the
+ *        statistic, the answer ends with the peak memory of the daemon.
+ */
+class Daemon {
+public:
+	/// how many results are kept resident
+	static const size_t RESULT_CACHE = 256;
+	/// how long a connection may send nothing before it is closed
+	static const int IDLE_SECONDS = 60;
+
+	Daemon(const string& socket_path, const uint& nthreads);
+	~Daemon();
+
+	void serve();
+
+	static string render(const Model& model, const Request& r,
+			const Result& result);
+
+private:
+	/// a version of a model file: its modification time in seconds and
+	/// nanoseconds, its size and its inode; an edit within the second of
+	/// the last one still changes it
+	typedef std::tuple<long, long, long, ulong> Version;
+	typedef std::tuple<string, Version, Thread_State, size_p, size_p, ulong> Key;
+
+	/// a compiled model and the version of its file
+	struct Entry {
+		Version version;
+		shared_ptr<const Engine> engine;
+	};
+
+	/// a client connection and the bytes of its next request
+	struct Connection {
+		int fd;
+		string buffer;
+		std::chrono::steady_clock::time_point last; /// of its last bytes
+	};
+
+	const string socket_path;
+	const uint nthreads;
+	int listen_fd;
+	int wake[2]; /// a pipe that wakes up the poll of serve
+	std::atomic<bool> stopping;
+
+	std::mutex queue_mtx; /// guards ready, served and open
+	std::condition_variable queue_cv;
+	deque<Connection> ready;  /// with bytes to read, for the workers
+	deque<Connection> served; /// back from the workers, to poll again
+	set<int> open;            /// every open connection, see stop
+	vector<std::thread> workers;
+
+	std::mutex cache_mtx;
+	map<string, Entry> models;
+	map<Key, Result> results;
+	deque<Key> lru; /// result keys, oldest first
+
+	void work();
+	bool handle(Connection& c);
+	void close(const Connection& c);
+	void wake_up();
+	string answer(const string& line);
+	string analyze(const Request& r);
+	shared_ptr<const Engine> engine(const string& path, Version& version);
+	void stop();
+};
+
+/**
+ * @brief the thin client of the daemon: it sends the request of a command
+ *        line and prints the answer, exactly as the analysis itself would
+ */
+class Client {
+public:
+	static bool query(const string& socket_path, const Request& r,
+			ostream& out = cout);
+	static void shutdown(const string& socket_path);
+};
+
+} /* namespace sura */
+
+#endif /* DAEMON_HH_ */
@@ -0,0 +1,150 @@
+/*
+ * dense.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef DENSE_HH_
+#define DENSE_HH_
+
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "zobrist.hh"
+
+namespace sura {
+
+/**
+ * @brief a global state as a dense array of N counters of type C, one per
+ *        local state, N >= L. The counters of one state take N * sizeof(C)
+ *        bytes, a multiple of 16, so equality is a few 16-byte vector
+ *        compares. States are hashed incrementally, see Zobrist. Unused
+ *        counters (locals >= L) stay 0.
+ */
+template<class C, size_l N>
+struct Dense_State {
+	static_assert(N * sizeof(C) % 16 == 0, "counters must fill 16-byte lanes");
+
+	C counters[N];
+	Shared_State share;
+
+	Dense_State() :
+			share(0) {
+		std::memset(counters, 0, sizeof(counters));
+	}
+
+	Dense_State(const Thread_State& t, const size_p& n) :
+			share(t.share) {
+		std::memset(counters, 0, sizeof(counters));
+		counters[t.local] = n;
+	}
+
+	/// apply a transition: move a thread from dec to inc, or spawn one at inc
+	inline void update(const Local_State& dec, const Local_State& inc,
+			const bool& is_spawn) {
+		if (!is_spawn)
+			--counters[dec];
+		++counters[inc];
+	}
+
+	inline bool operator==(const Dense_State& other) const {
+		if (share != other.share)
+			return false;
+#ifdef __SSE2__
+		const char* a = reinterpret_cast<const char*>(counters);
+		const char* b = reinterpret_cast<const char*>(other.counters);
+		for (size_t i = 0; i < sizeof(counters); i += 16) {
+			const __m128i x = _mm_loadu_si128((const __m128i*) (a + i));
+			const __m128i y = _mm_loadu_si128((const __m128i*) (b + i));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff)
+				return false;
+		}
+		return true;
+#else
+		return std::memcmp(counters, other.counters, sizeof(counters)) == 0;
+#endif
+	}
+};
+
+/**
+ * @brief a set of dense states that also is the BFS worklist: states are
+ *        appended in the order they are inserted, and an open-addressing
+ *        table of indices finds duplicates. The search expands the states
+ *        in the order of their indices. The caller hashes the states, see
+ *        Zobrist; the set keeps the hashes to rehash without recomputing.
+ */
+template<class C, size_l N>
+class Dense_Set {
+public:
+	Dense_Set() :
+			table(1024, 0) {
+	}
+
+	/// insert g with hash h; false if it was inserted before
+	bool insert(const Dense_State<C, N>& g, const uint64_t& h) {
+		if (10 * (states.size() + 1) > 7 * table.size())
+			this->grow_table();
+		const uint64_t mask = table.size() - 1;
+		for (uint64_t i = h & mask;; i = (i + 1) & mask) {
+			if (table[i] == 0) {
+				states.emplace_back(g);
+				hashes.emplace_back(h);
+				table[i] = states.size();
+				return true;
+			}
+			if (hashes[table[i] - 1] == h && states[table[i] - 1] == g)
+				return false;
+		}
+	}
+
+	inline const Dense_State<C, N>& operator[](const size_t& i) const {
+		return states[i];
+	}
+	inline uint64_t hash(const size_t& i) const {
+		return hashes[i];
+	}
+	inline size_t size() const {
+		return states.size();
+	}
+	inline ulong bytes() const {
+		return states.capacity() * sizeof(Dense_State<C, N>)
+				+ (hashes.capacity() + table.size()) * sizeof(uint64_t);
+	}
+
+private:
+	vector<Dense_State<C, N>> states;
+	vector<uint64_t> hashes; /// the hash of every state
+	vector<uint64_t> table;  /// index + 1 into states, 0 is empty
+
+	void grow_table() {
+		vector<uint64_t>(2 * table.size(), 0).swap(table);
+		const uint64_t mask = table.size() - 1;
+		for (size_t k = 0; k < states.size(); ++k) {
+			auto i = hashes[k] & mask;
+			while (table[i] != 0)
+				i = (i + 1) & mask;
+			table[i] = k + 1;
+		}
+	}
+};
+
+/**
+ * @brief the smallest dense width N >= L that keeps a state's counters of
+ *        type C within a cache line, or 0 if there is none
+ * @param L
+ * @param width: bytes of a counter
+ * @return size_l
+ */
+inline size_l dense_width(const size_l& L, const uint& width) {
+	for (size_l N = 16; N <= 64; N *= 2)
+		if (L <= N)
+			return N * width <= 64 ? N : 0;
+	return 0;
+}
+
+} /* namespace sura */
+
+#endif /* DENSE_HH_ */
@@ -0,0 +1,287 @@
+/*
+ * dump.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "dump.hh"
+#include "store.hh"
+
+#include <cstring>
+
+namespace sura {
+
+namespace {
+
+const char MAGIC[8] = { 'E', 'C', 'U', 'T', 'D', 'M', 'P', '2' };
+
+inline uint64_t zigzag(const int64_t& v) {
+	return (uint64_t(v) << 1) ^ uint64_t(v >> 63);
+}
+
+inline int64_t unzigzag(const uint64_t& v) {
+	return int64_t(v >> 1) ^ -int64_t(v & 1);
+}
+
+/// FNV-1a, 32 bits
+uint32_t checksum(const string& data) {
+	uint32_t h = 2166136261u;
+	for (const auto& c : data)
+		h = (h ^ (unsigned char) c) * 16777619u;
+	return h;
+}
+
+} /* namespace */
+
+/////////////////////// writer ////////////////////////////////
+
+/**
+ * @brief create the dump file, write its header and start the writer thread
+ * @param filename
+ * @param header
+ */
+Dump_Writer::Dump_Writer(const string& filename, const Dump_Header& header) :
+		filename(filename), file(std::fopen(filename.c_str(), "wb")), count(
+				0), written(0), closing(false), failed(false) {
+	if (file == nullptr)
+		throw CONTROL::Error("cannot create " + filename);
+	const uint32_t fields[] = { header.S, header.L, header.init.share,
+			header.init.local, header.n, header.s, 0 };
+	if (!this->put(MAGIC, sizeof(MAGIC)) || !this->put(fields, sizeof(fields))) {
+		std::fclose(file);
+		throw CONTROL::Error("cannot write " + filename);
+	}
+	writer = std::thread(&Dump_Writer::work, this);
+}
+
+Dump_Writer::~Dump_Writer() {
+	try {
+		this->close();
+	} catch (const CONTROL::Error&) {
+	}
+}
+
+/**
+ * @brief write the last block and the end of the dump, and wait for the
+ *        writer thread
+ * @param complete: the states added are all reachable states: the search
+ *                  ran to its end and stored its states exactly. Only
+ *                  then may Incremental read the dump
+ */
+void Dump_Writer::close(const bool& complete) {
+	if (file == nullptr)
+		return;
+	if (current.states > 0)
+		this->hand_off();
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		closing = true;
+		cv.notify_all();
+	}
+	writer.join();
+	const uint32_t end[] = { 0, 0, 0 };
+	const uint64_t total = count;
+	if (!this->put(end, sizeof(end)) || !this->put(&total, sizeof(total)))
+		failed = true;
+	const uint32_t flag = 1; /// the last field of the header, written over
+	if (complete
+			&& (std::fseek(file, sizeof(MAGIC) + 6 * sizeof(uint32_t), SEEK_SET)
+					!= 0 || std::fwrite(&flag, sizeof(flag), 1, file) != 1))
+		failed = true;
+	if (std::fclose(file) != 0)
+		failed = true;
+	file = nullptr;
+	if (failed)
+		throw CONTROL::Error("cannot write " + filename);
+}
+
+/**
+ * @brief queue the current block for the writer thread, waiting while
+ *        MAX_PENDING blocks are queued
+ */
+void Dump_Writer::hand_off() {
+	std::unique_lock<std::mutex> lock(mtx);
+	cv.wait(lock, [this] {
+		return pending.size() < MAX_PENDING;
+	});
+	pending.emplace_back();
+	pending.back().words.reserve(current.words.size());
+	std::swap(pending.back(), current);
+	cv.notify_all();
+}
+
+/**
+ * @brief the writer thread: encode and write the queued blocks in order
+ */
+void Dump_Writer::work() {
+	string payload;
+	while (true) {
+		Block block;
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			cv.wait(lock, [this] {
+				return closing || !pending.empty();
+			});
+			if (pending.empty())
+				return;
+			std::swap(block, pending.front());
+			pending.pop_front();
+			cv.notify_all();
+		}
+		if (!failed)
+			this->write_block(block, payload);
+	}
+}
+
+/**
+ * @brief delta-encode a block and write it
+ * @param block
+ * @param payload: a buffer, reused across blocks
+ */
+void Dump_Writer::write_block(const Block& block, string& payload) {
+	payload.clear();
+	/// the changed counters of a state: (local, new counter - old counter);
+	/// both states list their occupied locals in increasing order
+	vector<std::pair<Local_State, int64_t>> changes;
+	const size_p* prev = nullptr; /// the pairs of the previous state
+	size_p nprev = 0;
+	int64_t share = 0;
+	const size_p* w = block.words.data();
+	for (uint i = 0; i < block.states; ++i) {
+		State_Codec::put_varint(zigzag(int64_t(w[0]) - share), payload);
+		share = w[0];
+		const size_p* cur = w + 2;
+		const size_p ncur = w[1];
+		changes.clear();
+		size_p j = 0, k = 0;
+		while (j < nprev || k < ncur) {
+			if (k == ncur || (j < nprev && prev[2 * j] < cur[2 * k])) {
+				changes.emplace_back(prev[2 * j], -int64_t(prev[2 * j + 1]));
+				++j;
+			} else if (j == nprev || cur[2 * k] < prev[2 * j]) {
+				changes.emplace_back(cur[2 * k], int64_t(cur[2 * k + 1]));
+				++k;
+			} else {
+				if (cur[2 * k + 1] != prev[2 * j + 1])
+					changes.emplace_back(cur[2 * k],
+							int64_t(cur[2 * k + 1]) - int64_t(prev[2 * j + 1]));
+				++j, ++k;
+			}
+		}
+		State_Codec::put_varint(changes.size(), payload);
+		Local_State last = 0;
+		for (const auto& c : changes) {
+			State_Codec::put_varint(c.first - last, payload);
+			State_Codec::put_varint(zigzag(c.second), payload);
+			last = c.first;
+		}
+		prev = cur, nprev = ncur;
+		w = cur + 2 * ncur;
+	}
+	const uint32_t frame[] = { block.states, uint32_t(payload.size()),
+			checksum(payload) };
+	if (!this->put(frame, sizeof(frame))
+			|| !this->put(payload.data(), payload.size()))
+		failed = true;
+}
+
+bool Dump_Writer::put(const void* data, const size_t& size) {
+	if (std::fwrite(data, 1, size, file) != size)
+		return false;
+	written += size;
+	return true;
+}
+
+/////////////////////// reader ////////////////////////////////
+
+/**
+ * @brief open a dump and read its header
+ * @param filename
+ */
+Dump_Reader::Dump_Reader(const string& filename) :
+		filename(filename), file(std::fopen(filename.c_str(), "rb")), count(
+				0), pos(nullptr), left(0) {
+	if (file == nullptr)
+		throw CONTROL::Error("cannot open " + filename);
+	char magic[sizeof(MAGIC)];
+	uint32_t fields[7];
+	try {
+		this->get(magic, sizeof(magic));
+		if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+			throw CONTROL::Error(filename + " is not a state dump");
+		this->get(fields, sizeof(fields));
+	} catch (...) {
+		std::fclose(file);
+		throw;
+	}
+	head = Dump_Header(fields[0], fields[1],
+			Thread_State(fields[2], fields[3]), fields[4], fields[5],
+			fields[6] != 0);
+}
+
+Dump_Reader::~Dump_Reader() {
+	std::fclose(file);
+}
+
+/**
+ * @brief read the next state
+ * @param g
+ * @return false at the end of the dump
+ */
+bool Dump_Reader::next(Global_State& g) {
+	if (left == 0 && !this->load_block())
+		return false;
+	const char* end = payload.data() + payload.size();
+	last.share += unzigzag(State_Codec::get_varint(pos));
+	const auto changed = State_Codec::get_varint(pos);
+	Local_State l = 0;
+	for (uint64_t k = 0; k < changed; ++k) {
+		l += State_Codec::get_varint(pos);
+		const int64_t delta = unzigzag(State_Codec::get_varint(pos));
+		const int64_t c = (last.locals.count(l) ? last.locals[l] : 0) + delta;
+		if (c < 0)
+			throw CONTROL::Error("corrupt block in " + filename);
+		if (c == 0)
+			last.locals.erase(l);
+		else
+			last.locals[l] = c;
+	}
+	if (pos > end)
+		throw CONTROL::Error("corrupt block in " + filename);
+	--left;
+	++count;
+	g = last;
+	return true;
+}
+
+/**
+ * @brief read and check the next block
+ * @return false at the end of the dump
+ */
+bool Dump_Reader::load_block() {
+	uint32_t frame[3];
+	this->get(frame, sizeof(frame));
+	if (frame[0] == 0) {
+		uint64_t total;
+		this->get(&total, sizeof(total));
+		if (total != count)
+			throw CONTROL::Error("truncated dump " + filename);
+		return false;
+	}
+	payload.resize(frame[1]);
+	this->get(&payload[0], payload.size());
+	if (checksum(payload) != frame[2])
+		throw CONTROL::Error("corrupt block in " + filename);
+	pos = payload.data();
+	left = frame[0];
+	last = Global_State();
+	return true;
+}
+
+void Dump_Reader::get(void* data, const size_t& size) {
+	if (std::fread(data, 1, size, file) != size)
+		throw CONTROL::Error("truncated dump " + filename);
+}
+
+} /* namespace sura */
@@ -0,0 +1,191 @@
+/*
+ * dump.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef DUMP_HH_
+#define DUMP_HH_
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#include "dense.hh"
+
+namespace sura {
+
+/// what a dump was computed from
+struct Dump_Header {
+	size_s S;
+	size_l L;
+	Thread_State init;
+	size_p n;
+	size_p s;
+	bool complete; /// the dump holds every reachable state, see close
+
+	Dump_Header() :
+			S(0), L(0), init(), n(0), s(0), complete(false) {
+	}
+	Dump_Header(const size_s& S, const size_l& L, const Thread_State& init,
+			const size_p& n, const size_p& s, const bool& complete = false) :
+			S(S), L(L), init(init), n(n), s(s), complete(complete) {
+	}
+};
+
+/**
+ * @brief writes global states to a binary dump file. The file is
+ *          "ECUTDMP2" S L init.share init.local n s complete (u32 each)
+ *        followed by blocks of at most BLOCK_STATES states,
+ *          <states> <bytes> <FNV-1a checksum of payload> (u32 each) <payload>
+ *        and ends with an empty block and the number of states (u64).
+ *        complete is 0 until close records that the dump holds every
+ *        reachable state. In a
+ *        payload, every state is delta-encoded against the one before it in
+ *        the block: the change of its shared state, then the number of
+ *        changed counters and, per changed counter, the distance of its
+ *        local state to the previous changed one and the change of the
+ *        counter, all as (zigzag) varints. Consecutive states of a search
+ *        differ in a few counters, so a state takes a few bytes; each block
+ *        decodes on its own.
+ *        The search only copies its states into the current block; a
+ *        background thread encodes and writes full blocks, and the search
+ *        waits for it only if MAX_PENDING blocks are queued.
+ */
+class Dump_Writer {
+public:
+	/// states per block
+	static const uint BLOCK_STATES = 1 << 16;
+	/// full blocks queued for the writer thread at most
+	static const uint MAX_PENDING = 4;
+
+	Dump_Writer(const string& filename, const Dump_Header& header);
+	Dump_Writer(const Dump_Writer&) = delete;
+	Dump_Writer& operator=(const Dump_Writer&) = delete;
+	~Dump_Writer();
+
+	template<class C>
+	void add(const Global_State_T<C>& g);
+	template<class C, size_l N>
+	void add(const Dense_State<C, N>& g);
+
+	void close(const bool& complete = false);
+
+	/// the states added so far
+	inline ulong size() const {
+		return count;
+	}
+	/// the bytes written, once closed
+	inline ulong bytes() const {
+		return written;
+	}
+
+private:
+	/// the states of a block, each as: share, #pairs, (local, counter)*
+	struct Block {
+		uint states;
+		vector<size_p> words;
+
+		Block() :
+				states(0) {
+		}
+	};
+
+	string filename;
+	std::FILE* file;
+	ulong count;
+	ulong written;
+	Block current;
+
+	std::thread writer;
+	std::mutex mtx;
+	std::condition_variable cv;
+	deque<Block> pending;
+	bool closing;
+	bool failed; /// a write has failed; reported by close
+
+	void hand_off();
+	void work();
+	void write_block(const Block& block, string& payload);
+	bool put(const void* data, const size_t& size);
+};
+
+/**
+ * @brief append g to the current block
+ * @param g
+ */
+template<class C>
+void Dump_Writer::add(const Global_State_T<C>& g) {
+	current.words.emplace_back(g.share);
+	current.words.emplace_back(g.locals.size());
+	for (const auto& p : g.locals) {
+		current.words.emplace_back(p.first);
+		current.words.emplace_back(p.second);
+	}
+	++count;
+	if (++current.states == BLOCK_STATES)
+		this->hand_off();
+}
+
+/**
+ * @brief append g to the current block
+ * @param g
+ */
+template<class C, size_l N>
+void Dump_Writer::add(const Dense_State<C, N>& g) {
+	current.words.emplace_back(g.share);
+	const size_t size = current.words.size();
+	current.words.emplace_back(0);
+	for (size_l l = 0; l < N; ++l)
+		if (g.counters[l] > 0) {
+			current.words.emplace_back(l);
+			current.words.emplace_back(g.counters[l]);
+		}
+	current.words[size] = (current.words.size() - size - 1) / 2;
+	++count;
+	if (++current.states == BLOCK_STATES)
+		this->hand_off();
+}
+
+/**
+ * @brief reads the global states of a dump back, block by block, in the
+ *        order they were written
+ */
+class Dump_Reader {
+public:
+	explicit Dump_Reader(const string& filename);
+	Dump_Reader(const Dump_Reader&) = delete;
+	Dump_Reader& operator=(const Dump_Reader&) = delete;
+	~Dump_Reader();
+
+	inline const Dump_Header& header() const {
+		return head;
+	}
+
+	bool next(Global_State& g);
+
+	/// the states read so far
+	inline ulong size() const {
+		return count;
+	}
+
+private:
+	string filename;
+	std::FILE* file;
+	Dump_Header head;
+	ulong count;
+
+	string payload;  /// the current block
+	const char* pos; /// the next state in payload
+	uint left;       /// states left in payload
+	Global_State last;
+
+	bool load_block();
+	void get(void* data, const size_t& size);
+};
+
+} /* namespace sura */
+
+#endif /* DUMP_HH_ */
@@ -0,0 +1,98 @@
+/*
+ * engine.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "engine.hh"
+#include "fws.hh"
+#include "bws.hh"
+#include "modular.hh"
+
+namespace sura {
+
+Engine::Engine(const string& filename) :
+		compiled(Model::load(filename)) {
+}
+
+Engine::Engine(istream& in) :
+		compiled(Model::load(in)) {
+}
+
+Engine::Engine(const shared_ptr<const Model>& model) :
+		compiled(model) {
+	if (!compiled)
+		throw CONTROL::Error("Engine: no model");
+}
+
+/**
+ * @brief answer a query by a forward search
+ * @param q
+ * @param max_mem: memory budget of the search in bytes (0: unlimited)
+ * @param from   : the states of a query with the same initial state and
+ *                 bounds no larger than q's to start from, or nullptr
+ * @param to     : receives the states of q, if they were stored exactly,
+ *                 or nullptr
+ * @return Result
+ */
+Result Engine::query(const Query& q, culong& max_mem, const Seed* from,
+		Seed* to) const {
+	FWS fws(q.init, *compiled);
+	fws.set_memory_budget(max_mem);
+	if (from != nullptr) {
+		if (!(from->query.init == q.init))
+			throw CONTROL::Error("the seed has another initial state");
+		fws.set_seed(&from->states, from->query.n, from->query.s);
+	}
+	if (to != nullptr) {
+		to->query = q;
+		fws.set_collect(&to->states);
+	}
+	const auto R = fws.explore(q.n, q.s);
+
+	Result result;
+	result.reachable = R.reachable;
+	result.states = R.states;
+	result.exact = R.is_exact();
+	result.store = State_Store_Base::mode_name(R.mode);
+	result.notes = R.notes;
+	return result;
+}
+
+/**
+ * @brief answer a query by a forward search
+ * @param init: the initial thread state
+ * @param n   : number of threads at the initial state
+ * @param s   : maximum number of spawn transitions
+ * @return Result
+ */
+Result Engine::query(const Thread_State& init, const size_p& n,
+		const size_p& s) const {
+	return this->query(Query(init, n, s));
+}
+
+/**
+ * @brief is target coverable from any number of threads at init, with any
+ *        number of spawn transitions? Answered by a backward search
+ * @param init
+ * @param target
+ * @return the smallest number of threads that covers target, or 0 if none
+ */
+size_p Engine::cover(const Thread_State& init,
+		const Thread_State& target) const {
+	return BWS(*compiled).cover(init, target);
+}
+
+/**
+ * @brief an over-approximation of the thread states reachable under q, by
+ *        the thread-modular analysis: a thread state it rules out is
+ *        unreachable
+ * @param q
+ * @return S x L: false for the thread states that are unreachable
+ */
+vector<vector<bool>> Engine::over_approximate(const Query& q) const {
+	return Thread_Modular(*compiled).run(q.init, q.n, q.s);
+}
+
+} /* namespace sura */
@@ -0,0 +1,86 @@
+/*
+ * engine.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef ENGINE_HH_
+#define ENGINE_HH_
+
+#include "model.hh"
+
+namespace sura {
+
+/// a reachability query: n threads start at init, at most s spawns
+struct Query {
+	Thread_State init;
+	size_p n;
+	size_p s;
+
+	Query(const Thread_State& init, const size_p& n, const size_p& s) :
+			init(init), n(n), s(s) {
+	}
+};
+
+/// the answer to a query
+struct Result {
+	vector<vector<bool>> reachable; /// S x L: reachable thread states
+	ulong states;                   /// reachable global states
+	bool exact;                     /// false if states may have been missed
+	string store;                   /// how the states were stored at the end
+	vector<string> notes; /// e.g., the switches of the memory budget
+
+	Result() :
+			states(0), exact(true) {
+	}
+
+	inline bool is_reachable(const Thread_State& t) const {
+		return reachable[t.share][t.local];
+	}
+};
+
+/// the reachable global states of a query, from which the search of a
+/// query with the same initial state and larger bounds starts. The states
+/// are encoded as words one after the other, see FWS::set_collect
+struct Seed {
+	Query query;
+	vector<size_p> states;
+
+	Seed() :
+			query(Thread_State(), 0, 0) {
+	}
+};
+
+/**
+ * @brief the library entry point: an engine loads and compiles a model once
+ *        and then answers any number of queries on it. The compiled model is
+ *        immutable and every query runs its own search, so one engine can
+ *        be queried concurrently from many threads.
+ */
+class Engine {
+public:
+	explicit Engine(const string& filename);
+	explicit Engine(istream& in);
+	explicit Engine(const shared_ptr<const Model>& model);
+	~Engine() {
+	}
+
+	inline const Model& model() const {
+		return *compiled;
+	}
+
+	Result query(const Query& q, culong& max_mem = 0, const Seed* from =
+			nullptr, Seed* to = nullptr) const;
+	Result query(const Thread_State& init, const size_p& n,
+			const size_p& s) const;
+	size_p cover(const Thread_State& init, const Thread_State& target) const;
+	vector<vector<bool>> over_approximate(const Query& q) const;
+
+private:
+	shared_ptr<const Model> compiled;
+};
+
+} /* namespace sura */
+
+#endif /* ENGINE_HH_ */
@@ -7,89 +7,1082 @@
 
 #include "fws.hh"
 
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <signal.h>
+
 namespace sura {
 
-FWS::FWS() {
-	// TODO Auto-generated constructor stub
+/**
+ * @brief a forward search over a compiled model. The model is not copied:
+ *        it must outlive the search
+ * @param init_ts: the initial thread state
+ * @param model
+ */
+FWS::FWS(const Thread_State& init_ts, const Model& model) :
+		init_ts(init_ts), model(model), stats(nullptr), progress(nullptr), max_mem(
+				0), known(nullptr), complete(true), seed(nullptr), seed_n(0), seed_s(
+				0), collect(nullptr), repr(AUTO), dump(nullptr), trace(
+				nullptr), nthreads(1), processes(1), gallop_cutoff(false), timeout(0), max_states(
+				0), interruptible(false) {
+	if (!model.contains(init_ts))
+		throw CONTROL::Error("initial thread state out of range");
+}
+
+FWS::~FWS() {
+	// TODO Auto-generated destructor stub
 }
 
-FWS::FWS(const Thread_State& init_ts, const adjacency_list& TTD) :
-		init_ts(init_ts), TTD(TTD) {
+volatile std::sig_atomic_t FWS::interrupted = 0;
 
+void FWS::set_limits(const double& seconds, culong& max_states) {
+	this->timeout = seconds;
+	this->max_states = max_states;
+	this->deadline = std::chrono::steady_clock::now()
+			+ std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+					std::chrono::duration<double>(seconds));
 }
 
-FWS::~FWS() {
-	// TODO Auto-generated destructor stub
+void FWS::interrupt(int) {
+	interrupted = 1;
+}
+
+namespace {
+/// catches SIGINT and SIGTERM with a handler that raises flag while it
+/// lives, and restores the handlers they had before after
+class Signal_Guard {
+public:
+	Signal_Guard(const bool& on, void (*handler)(int),
+			volatile std::sig_atomic_t& flag) :
+			on(on) {
+		if (!on)
+			return;
+		flag = 0;
+		struct sigaction action;
+		std::memset(&action, 0, sizeof(action));
+		action.sa_handler = handler;
+		action.sa_flags = SA_RESTART;
+		sigemptyset(&action.sa_mask);
+		::sigaction(SIGINT, &action, &old_int);
+		::sigaction(SIGTERM, &action, &old_term);
+	}
+	~Signal_Guard() {
+		if (on) {
+			::sigaction(SIGINT, &old_int, nullptr);
+			::sigaction(SIGTERM, &old_term, nullptr);
+		}
+	}
+private:
+	const bool on;
+	struct sigaction old_int;
+	struct sigaction old_term;
+};
+}
+
+/**
+ * @brief should the running search stop? If so, record why
+ * @param states     : the states the search stored so far
+ * @param check_clock: whether to read the clock, which costs more than the
+ *                     other checks
+ * @return bool
+ */
+bool FWS::should_stop(culong& states, const bool& check_clock) {
+	if (this->full(states))
+		return true;
+	if (interruptible && interrupted)
+		stopped = "interrupt";
+	else if (timeout > 0 && check_clock
+			&& std::chrono::steady_clock::now() >= deadline)
+		stopped = "timeout";
+	else
+		return false;
+	complete = false;
+	return true;
+}
+
+/**
+ * @brief has the running search stored max_states states? If so, record
+ *        that it stopped, so that it stores no more
+ * @param states: the states the search stored so far
+ * @return bool
+ */
+bool FWS::full(culong& states) {
+	if (max_states == 0 || states < max_states)
+		return false;
+	stopped = "state limit";
+	complete = false;
+	return true;
 }
 
+/**
+ * @brief the cutoff: the first bound k, k threads at the initial state and k
+ *        spawn transitions, under which no more thread states are reachable
+ *        than under k - 1. Since more threads and spawns reach more, the
+ *        number of reachable thread states grows with k, and cutoff
+ *        detection assumes that it stays put once it stopped growing. It
+ *        scans the bounds 1, 2, 3, ...; set_gallop_cutoff probes the pairs
+ *        of bounds (b, b + 1) for b = 1, 4, 10, 22, ... (b' = 2b + 2) until
+ *        a pair agrees, or b reaches all thread states, and then searches
+ *        the first bound of that count by bisection: O(log k) searches
+ *        instead of k, for the same cutoff, none of them under a bound of
+ *        2k or more. Each is dearer than the last, though, so that only
+ *        pays when the cutoff is large.
+ */
 void FWS::cutoff_detection() {
 	size_p cutoff = 1;
-	uint oreach = 0, nreach = 0;
-	while (true) { /// we set this as 10, this is no good
-		auto R = this->standard_FWS(cutoff, cutoff);
-		auto mark_R = this->extract_reachable_TS(R);
-		nreach = this->statistic(mark_R);
-		cout << "Under Setting: " << cutoff << " threads at initial state, "
-				<< cutoff << " spawn transitions" << endl;
-		if (Refs::OPT_PRT_REACH_TS)
-			this->print_reachable_TS(mark_R); // print out all reachable thread states
-		if (Refs::OPT_PRT_UNREACH_TS)
-			this->print_unreachable_TS(mark_R); // print out all unreachable thread states
-
-		if (nreach == oreach)
-			break;
-		else
+	if (!gallop_cutoff) {
+		uint oreach = 0;
+		while (true) { /// we set this as 10, this is no good
+			const uint nreach = this->probe_cutoff(cutoff);
+			if (!stopped.empty())
+				return;
+			if (nreach == oreach)
+				break;
 			oreach = nreach;
-		++cutoff;
+			++cutoff;
+		}
+	} else {
+		map<size_p, uint> reach; /// by bound
+		auto count = [&](const size_p& k) {
+			const auto ir = reach.find(k);
+			if (ir != reach.end())
+				return ir->second;
+			return reach[k] = this->probe_cutoff(k);
+		};
+		const uint all = model.S() * model.L();
+		size_p lo = 1, hi = 1; /// count(lo - 1) < count(hi)
+		uint final = count(hi);
+		while (stopped.empty() && final < all) {
+			if (count(hi + 1) == final || !stopped.empty())
+				break;
+			lo = hi + 1;
+			hi = 2 * hi + 2;
+			final = count(hi);
+		}
+		while (stopped.empty() && lo < hi) { /// the first bound of final
+			const size_p mid = lo + (hi - lo) / 2;
+			if (count(mid) == final)
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		if (!stopped.empty())
+			return;
+		cutoff = hi + 1;
 	}
 	if (Refs::INPUT_IS_TTS)
-		this->standard_FWS(cutoff + 1, cutoff - 1);
+		this->explore(cutoff + 1, cutoff - 1);
 	cout << "cutoff is " << (cutoff + cutoff) << endl;
 }
 
+/**
+ * @brief search under the bound k of cutoff_detection and print the result
+ * @param k
+ * @return uint: the number of reachable thread states, 0 if the search
+ *         stopped early
+ */
+uint FWS::probe_cutoff(const size_p& k) {
+	const auto R = this->explore(k, k);
+	this->print_notes(R);
+	if (!R.stopped.empty()) {
+		cout << "Under Setting: " << k << " threads at initial state, " << k
+				<< " spawn transitions" << endl;
+		this->report_stopped(R);
+		cout << "cutoff is unknown" << endl;
+		return 0;
+	}
+	Stopwatch watch;
+	const auto& mark_R = R.reachable;
+	const uint nreach = this->statistic(mark_R);
+	cout << "Under Setting: " << k << " threads at initial state, " << k
+			<< " spawn transitions" << endl;
+	if (Refs::OPT_PRT_REACH_TS)
+		this->print_reachable_TS(mark_R); // print out all reachable thread states
+	if (Refs::OPT_PRT_UNREACH_TS)
+		this->print_unreachable_TS(mark_R); // print out all unreachable thread states
+	if (max_mem > 0)
+		this->print_exactness(R);
+	if (stats != nullptr)
+		stats->add_phase("report", watch.elapsed());
+	return nreach;
+}
+
+/**
+ * @brief compute the reachable thread states under one setting, and print
+ *        them out as requested on the command line
+ * @param n: number of threads at the initial states
+ * @param s: maximum number of spawn transition could be fired
+ * @return Search_Result
+ */
+Search_Result FWS::reachability_analysis(const size_p& n, const size_p& s) {
+	const auto R = this->explore(n, s);
+	this->report(R);
+	return R;
+}
+
+/**
+ * @brief print out the result of a search as requested on the command line
+ * @param R
+ */
+void FWS::report(const Search_Result& R) {
+	this->print_notes(R);
+	if (!R.stopped.empty()) {
+		this->report_stopped(R);
+		return;
+	}
+	Stopwatch watch;
+	const auto& mark_R = R.reachable;
+	if (Refs::OPT_PRT_REACH_TS)
+		this->print_reachable_TS(mark_R); // print out all reachable thread states
+	if (Refs::OPT_PRT_UNREACH_TS)
+		this->print_unreachable_TS(mark_R); // print out all unreachable thread states
+	if (Refs::OPT_PRT_STATISTIC) {
+		cout << "current # of   reachable Global States: " << R.states
+				<< "\n";
+		this->statistic(mark_R);
+	}
+	if (max_mem > 0)
+		this->print_exactness(R);
+	if (stats != nullptr)
+		stats->add_phase("report", watch.elapsed());
+}
+
+/**
+ * @brief print out the result of a search that stopped early: the thread
+ *        states it reached are proven reachable, and the others unknown
+ * @param R
+ */
+void FWS::report_stopped(const Search_Result& R) {
+	uint nreach = 0;
+	for (size_s s = 0; s < model.S(); ++s)
+		for (size_l l = 0; l < model.L(); ++l)
+			if (R.reachable[s][l])
+				++nreach;
+	cout << "the search stopped early (" << R.stopped << ") after "
+			<< R.states << " global states: " << nreach << " of "
+			<< model.S() * model.L() << " thread states proven reachable, "
+			<< model.S() * model.L() - nreach << " unknown\n";
+	this->print_reachable_TS(R.reachable);
+	if (Refs::OPT_PRT_UNREACH_TS) {
+		cout << "Unknown Thread States:\n";
+		for (size_s s = 0; s < model.S(); ++s)
+			for (size_l l = 0; l < model.L(); ++l)
+				if (!R.reachable[s][l])
+					cout << s << "|" << l << "\n";
+		cout << endl;
+	}
+	if (max_mem > 0)
+		this->print_exactness(R);
+}
+
+/**
+ * @brief print out what the search recorded along the way, see
+ *        Search_Result, and its summary with --statistic
+ * @param R
+ */
+void FWS::print_notes(const Search_Result& R) {
+	for (const auto& note : R.notes)
+		cout << note << "\n";
+	if (Refs::OPT_PRT_STATISTIC && !R.summary.empty())
+		cout << R.summary << "\n";
+	cout << std::flush;
+}
+
+/**
+ * @brief a forward search whose states have the narrowest counters that
+ *        hold n + s threads: uint8_t, uint16_t or uint32_t. The states are
+ *        dense (Dense_State) if their counters fit in a cache line and no
+ *        memory budget is set, and sparse (Global_State_T) otherwise;
+ *        set_representation overrides the choice, and also selects the
+ *        level-synchronous search over packed states, or the symbolic
+ *        search. With more than one process, see set_processes, the search
+ *        is sharded over processes
+ * @param n: number of threads at the initial states
+ * @param s: maximum number of spawn transition could be fired
+ * @return Search_Result
+ */
+Search_Result FWS::explore(const size_p& n, const size_p& s) {
+	const auto width = counter_width(ulong(n) + s);
+	if (seed != nullptr
+			&& (repr == SYMBOLIC || repr == PACKED || processes > 1
+					|| trace != nullptr))
+		throw CONTROL::Error(
+				"a seeded search needs dense or sparse states and no trace");
+	if (seed != nullptr && (seed_n > n || seed_s > s))
+		throw CONTROL::Error("the seed has larger bounds than the search");
+	if (collect != nullptr)
+		collect->clear();
+	if (repr == SYMBOLIC) {
+		if (max_mem > 0 || trace != nullptr || dump != nullptr || processes > 1
+				|| timeout > 0 || max_states > 0)
+			throw CONTROL::Error(
+					"a symbolic search supports no memory budget, trace, dump, processes or limits");
+		return this->symbolic_FWS(n, s);
+	}
+	if (processes > 1) {
+		if (max_mem > 0 || trace != nullptr || dump != nullptr || timeout > 0
+				|| max_states > 0)
+			throw CONTROL::Error(
+					"a sharded search supports no memory budget, trace, dump or limits");
+		const Packing packing(model.S(), model.L(), ulong(n) + s);
+		switch (packing.words()) {
+		case 1:
+			return this->sharded_FWS<1>(n, s, packing);
+		case 2:
+			return this->sharded_FWS<2>(n, s, packing);
+		case 3:
+			return this->sharded_FWS<3>(n, s, packing);
+		case 4:
+			return this->sharded_FWS<4>(n, s, packing);
+		default:
+			throw CONTROL::Error("too many local states for packed states");
+		}
+	}
+	const Signal_Guard guard(interruptible, FWS::interrupt, interrupted);
+	if (repr == PACKED) {
+		if (max_mem > 0 || trace != nullptr)
+			throw CONTROL::Error(
+					"packed states support neither a memory budget nor traces");
+		const Packing packing(model.S(), model.L(), ulong(n) + s);
+		switch (packing.words()) {
+		case 1:
+			return this->packed_FWS<1>(n, s, packing);
+		case 2:
+			return this->packed_FWS<2>(n, s, packing);
+		case 3:
+			return this->packed_FWS<3>(n, s, packing);
+		case 4:
+			return this->packed_FWS<4>(n, s, packing);
+		default:
+			throw CONTROL::Error("too many local states for packed states");
+		}
+	}
+	const size_l N = dense_width(model.L(), width);
+	if (repr == DENSE && (N == 0 || max_mem > 0))
+		throw CONTROL::Error(
+				max_mem > 0 ?
+						"the memory budget needs sparse states" :
+						"too many local states for dense states");
+	if (repr == DENSE || (repr == AUTO && N > 0 && max_mem == 0)) {
+		switch (width) {
+		case COUNTER_8:
+			return N == 16 ? this->dense_FWS<uint8_t, 16>(n, s) :
+					N == 32 ?
+							this->dense_FWS<uint8_t, 32>(n, s) :
+							this->dense_FWS<uint8_t, 64>(n, s);
+		case COUNTER_16:
+			return N == 16 ? this->dense_FWS<uint16_t, 16>(n, s) :
+					this->dense_FWS<uint16_t, 32>(n, s);
+		default:
+			return this->dense_FWS<uint32_t, 16>(n, s);
+		}
+	}
+	switch (width) {
+	case COUNTER_8:
+		return this->explore<uint8_t>(n, s);
+	case COUNTER_16:
+		return this->explore<uint16_t>(n, s);
+	default:
+		return this->explore<uint32_t>(n, s);
+	}
+}
+
+/**
+ * @brief a forward search with counters of type C
+ * @param n
+ * @param s
+ * @return Search_Result
+ */
+template<class C>
+Search_Result FWS::explore(const size_p& n, const size_p& s) {
+	const auto R = this->standard_FWS<C>(n, s);
+	Search_Result result;
+	result.reachable = this->extract_reachable_TS(R);
+	result.states = R.size();
+	result.mode = R.mode();
+	result.stopped = stopped;
+	result.notes = notes;
+	if (collect != nullptr && complete && R.mode() == State_Store_Base::EXACT)
+		for (const auto& g : R.states()) {
+			collect->emplace_back(g.share);
+			collect->emplace_back(g.locals.size());
+			for (const auto& p : g.locals) {
+				collect->emplace_back(p.first);
+				collect->emplace_back(p.second);
+			}
+		}
+	return result;
+}
+
 /**
  * @brief standard forward search: to compute the set of reachable thread state which n
  * 			threads in initial state and at most s threads created dynamically
- * @param TTD: TTD represented in a adjacency list
+ *        The spawn budget is per state: every run fires at most s spawn
+ *        transitions. As a spawn adds a thread and no thread terminates,
+ *        the budget of a state is n + s minus its threads; a state thus
+ *        determines its budget, and is never reached with two budgets
  * @param n  : number of threads at the initial states
  * @param s  : maximum number of spawn transition could be fired
  */
-set<Global_State> FWS::standard_FWS(const size_p& n, const size_p& s) {
-	auto spw = s; /// local copy of maximum number of spawn transition could be fired
-	queue<Global_State, deque<Global_State>> W; /// worklist
-	W.emplace(init_ts, n); /// start from the initial state with n threads
-	set<Global_State> R; /// reachable global states
+template<class C>
+State_Store<C> FWS::standard_FWS(const size_p& n, const size_p& s) {
+	if (ulong(n) + s > std::numeric_limits<C>::max())
+		throw CONTROL::Error("standard_FWS: counters too narrow");
+	Stopwatch watch, level_watch;
+	Search_Profile profile(n, s); /// counters are cheap; they are only
+	Level_Profile level = { 0, 0, 0, 0, 0, 0 }; /// reported if stats != nullptr
+	ulong level_size = 1; /// number of states in the current level left
+	vector<bool> reached; /// reached thread states, kept only for progress
+	ulong nreached = this->begin_search(n, s, reached); /// and stopping early
+
+	const auto zobrist = std::make_shared<const Zobrist>(model.S(), model.L(),
+			ulong(n) + s);
+	const Global_State_T<C> init(init_ts, n); /// n threads at the initial state
+	Worklist<C> W; /// worklist
+	State_Store<C> R(model.S(), model.L(), zobrist); /// reachable global states
+	auto visit = [&](const Global_State_T<C>& g) {
+		if (dump != nullptr)
+			dump->add(g);
+		if (!reached.empty())
+			for (const auto& p : g.locals) {
+				auto ts = model.index(Thread_State(g.share, p.first));
+				if (!reached[ts])
+					reached[ts] = true, ++nreached;
+			}
+	};
+	ulong nseeds = 0; /// the open seeds, the first states of W
+	bool idle = false, spawns = false; /// the moves new to an open seed
+	if (seed != nullptr) {
+		for (size_t i = 0; i < seed->size(); i += 2 + 2 * (*seed)[i + 1]) {
+			const size_p* g = &(*seed)[i];
+			Global_State_T<C> _g;
+			_g.share = g[0];
+			ulong threads = n - seed_n;
+			for (size_p j = 0; j < g[1]; ++j) {
+				_g.locals.emplace_hint(_g.locals.end(), g[2 + 2 * j],
+						g[3 + 2 * j]);
+				threads += g[3 + 2 * j];
+			}
+			if (n > seed_n)
+				_g.locals[init_ts.local] += n - seed_n;
+			if (R.insert(_g, zobrist->hash(_g))) {
+				visit(_g);
+				const auto ii = _g.locals.find(init_ts.local);
+				if (this->seed_moves(ii == _g.locals.end() ? 0 : ii->second,
+						threads, n, s, idle, spawns))
+					W.push(_g);
+			}
+		}
+		nseeds = W.size();
+	}
+	if (R.insert(init, zobrist->hash(init))) {
+		visit(init);
+		W.push(init);
+	}
+	if (trace != nullptr)
+		trace->begin(init_ts, n);
+	level_size = W.size();
+	ulong id = 0; /// the number of tau, see Trace
 	while (!W.empty()) {
-		Global_State tau = W.front();
-		W.pop();
+		if (known != nullptr && nreached == reached.size()) {
+			complete = false; /// every thread state is known to be reachable
+			break;
+		}
+		if (this->should_stop(R.size(), level.expanded % BUDGET_PERIOD == 0))
+			break;
+		if (W.size() > profile.peak_frontier)
+			profile.peak_frontier = W.size();
+		Global_State_T<C> tau = W.pop();
+		const ulong tau_id = id++;
+		level.expanded++;
 		const ushort &shared = tau.share;
+		/// the successors' hashes follow from tau's
+		const uint64_t h = zobrist->hash(tau);
+		/// the spawn transitions tau may still fire: each one has added a
+		/// thread, and no thread terminates
+		ulong threads = 0;
+		for (const auto& p : tau.locals)
+			threads += p.second;
+		const ulong budget = ulong(n) + s - threads;
+		const bool is_seed = tau_id < nseeds; /// fires only the new moves
+		if (is_seed) {
+			const auto ii = tau.locals.find(init_ts.local);
+			this->seed_moves(ii == tau.locals.end() ? 0 : ii->second, threads,
+					n, s, idle, spawns);
+		}
 		for (auto il = tau.locals.begin(); il != tau.locals.end(); il++) {
 			Thread_State src(shared, il->first);
-			auto ifind = TTD.find(src);
-			if (ifind != TTD.end()) {
-				for (auto idst = ifind->second.begin();
-						idst != ifind->second.end(); idst++) {
-					bool is_spawn = Util::is_spawn_transition(src, *idst); // if (src, dst) is a spawn transition
-					if (is_spawn) {
-						if (spw > 0) {
-							spw--;
-						} else { // if the we already fire s spawn transitions, then
-							continue; // we can't spawn again and have to skip src +> dst;
-						}
-					}
-					Global_State _tau(idst->share,
-							this->update_counter(tau.locals, src.local,
-									idst->local, is_spawn)); // successor of tau
-					if (R.emplace(_tau).second) { // if _tau is haven't been reached before
-						W.emplace(_tau);
+			for (const auto& e : model.successors(src)) {
+				if (this->full(R.size()))
+					break;
+				if (is_seed && !(idle && src.local == init_ts.local)
+						&& !(spawns && e.is_spawn))
+					continue;
+				if (e.is_spawn) { // if (src, dst) is a spawn transition
+					if (budget == 0) // tau has fired s spawn transitions
+						continue;
+					level.spawns++;
+				}
+				level.edges++;
+				Global_State_T<C> _tau(e.dst.share,
+						this->update_counter(tau.locals, src.local,
+								e.dst.local, e.is_spawn)); // successor of tau
+				const auto iinc = tau.locals.find(e.dst.local);
+				const uint64_t _h = zobrist->successor(h, shared, e.dst.share,
+						src.local, il->second, e.dst.local,
+						iinc == tau.locals.end() ? 0 : iinc->second,
+						e.is_spawn);
+				__SAFE_ASSERT__(_h == zobrist->hash(_tau));
+				if (R.insert(_tau, _h)) { // if _tau is haven't been reached before
+					visit(_tau);
+					if (trace != nullptr) {
+						const auto _id = trace->add(tau_id,
+								model.edge_id(src, e));
+						if (_id != Trace::NONE)
+							for (const auto& p : _tau.locals)
+								trace->reach(Thread_State(_tau.share, p.first),
+										_id);
 					}
+					W.push(_tau);
+				} else {
+					level.duplicates++;
 				}
 			}
 		}
+		if (--level_size == 0) { /// the current BFS level is done
+			level_size = W.size();
+			this->end_level(profile, level, level_watch);
+		}
+		if (progress != nullptr
+				&& (level_size == W.size()
+						|| level.expanded % Progress::PUBLISH_PERIOD == 0)) {
+			progress->states.store(R.size(), std::memory_order_relaxed);
+			progress->frontier.store(W.size(), std::memory_order_relaxed);
+			progress->depth.store(level.depth, std::memory_order_relaxed);
+			progress->reached_ts.store(nreached, std::memory_order_relaxed);
+		}
+		if (max_mem > 0 && level.expanded % BUDGET_PERIOD == 0)
+			this->enforce_budget(R, W);
+	}
+	if (stats != nullptr) {
+		profile.time = watch.elapsed();
+		profile.states = R.size();
+		profile.store = State_Store_Base::mode_name(R.mode());
+		profile.counter = sizeof(C);
+		profile.exact = R.is_exact();
+		profile.notes = notes;
+		if (R.mode() == State_Store_Base::EXACT)
+			profile.by_share = R.partition_sizes();
+		this->measure_bytes(profile, R);
+		stats->add_phase("search", profile.time);
+		stats->add_search(profile);
 	}
 	return R;
 }
 
+/**
+ * @brief a forward search over dense states, see Dense_State. It reaches
+ *        the same states as standard_FWS
+ * @param n: number of threads at the initial states
+ * @param s: maximum number of spawn transition could be fired
+ * @return Search_Result
+ */
+template<class C, size_l N>
+Search_Result FWS::dense_FWS(const size_p& n, const size_p& s) {
+	if (ulong(n) + s > std::numeric_limits<C>::max() || model.L() > N)
+		throw CONTROL::Error("dense_FWS: counters too narrow");
+	Stopwatch watch, level_watch;
+	Search_Profile profile(n, s);
+	Level_Profile level = { 0, 0, 0, 0, 0, 0 };
+	ulong level_size = 1;
+	vector<bool> reached;
+	ulong nreached = this->begin_search(n, s, reached);
+
+	const Zobrist zobrist(model.S(), model.L(), ulong(n) + s);
+	const Dense_State<C, N> init(init_ts, n);
+	Dense_Set<C, N> R; /// reachable global states, and the worklist behind
+	size_t next = 0;   /// the next state to expand
+	auto visit = [&](const Dense_State<C, N>& g) {
+		if (dump != nullptr)
+			dump->add(g);
+		if (!reached.empty())
+			for (Local_State k = 0; k < model.L(); ++k) {
+				if (g.counters[k] == 0)
+					continue;
+				auto ts = model.index(Thread_State(g.share, k));
+				if (!reached[ts])
+					reached[ts] = true, ++nreached;
+			}
+	};
+	size_t nseeds = 0; /// the open seeds end before R[nseeds]
+	bool idle = false, spawns = false; /// the moves new to an open seed
+	if (seed != nullptr) { /// the closed seeds go before next, so only the
+		vector<Dense_State<C, N>> open; /// open ones are expanded
+		for (size_t i = 0; i < seed->size(); i += 2 + 2 * (*seed)[i + 1]) {
+			const size_p* g = &(*seed)[i];
+			Dense_State<C, N> _g;
+			_g.share = g[0];
+			for (size_p j = 0; j < g[1]; ++j)
+				_g.counters[g[2 + 2 * j]] = g[3 + 2 * j];
+			_g.counters[init_ts.local] += n - seed_n;
+			ulong threads = 0;
+			for (Local_State l = 0; l < model.L(); ++l)
+				threads += _g.counters[l];
+			if (this->seed_moves(_g.counters[init_ts.local], threads, n, s,
+					idle, spawns))
+				open.emplace_back(_g);
+			else if (R.insert(_g, zobrist.hash(_g)))
+				visit(_g);
+		}
+		next = R.size();
+		for (const auto& _g : open)
+			if (R.insert(_g, zobrist.hash(_g)))
+				visit(_g);
+		nseeds = R.size();
+	}
+	if (R.insert(init, zobrist.hash(init)))
+		visit(init);
+	if (trace != nullptr)
+		trace->begin(init_ts, n);
+	level_size = R.size() - next;
+	while (next < R.size()) {
+		if (known != nullptr && nreached == reached.size()) {
+			complete = false;
+			break;
+		}
+		if (this->should_stop(R.size(), level.expanded % BUDGET_PERIOD == 0))
+			break;
+		if (R.size() - next > profile.peak_frontier)
+			profile.peak_frontier = R.size() - next;
+		const Dense_State<C, N> tau = R[next];
+		const ulong tau_id = next; /// the number of tau, see Trace
+		const uint64_t h = R.hash(next++);
+		level.expanded++;
+		ulong threads = 0;
+		for (Local_State l = 0; l < model.L(); ++l)
+			threads += tau.counters[l];
+		const ulong budget = ulong(n) + s - threads;
+		const bool is_seed = tau_id < nseeds; /// fires only the new moves
+		if (is_seed)
+			this->seed_moves(tau.counters[init_ts.local], threads, n, s, idle,
+					spawns);
+		for (Local_State l = 0; l < model.L(); ++l) {
+			if (tau.counters[l] == 0)
+				continue;
+			for (const auto& e : model.successors(Thread_State(tau.share, l))) {
+				if (this->full(R.size()))
+					break;
+				if (is_seed && !(idle && l == init_ts.local)
+						&& !(spawns && e.is_spawn))
+					continue;
+				if (e.is_spawn) {
+					if (budget == 0)
+						continue;
+					level.spawns++;
+				}
+				level.edges++;
+				Dense_State<C, N> _tau(tau);
+				_tau.update(l, e.dst.local, e.is_spawn);
+				_tau.share = e.dst.share;
+				const uint64_t _h = zobrist.successor(h, tau.share,
+						e.dst.share, l, tau.counters[l], e.dst.local,
+						tau.counters[e.dst.local], e.is_spawn);
+				__SAFE_ASSERT__(_h == zobrist.hash(_tau));
+				if (R.insert(_tau, _h)) {
+					visit(_tau);
+					if (trace != nullptr) {
+						const auto _id = trace->add(tau_id,
+								model.edge_id(Thread_State(tau.share, l), e));
+						if (_id != Trace::NONE)
+							for (Local_State k = 0; k < model.L(); ++k)
+								if (_tau.counters[k] > 0)
+									trace->reach(Thread_State(_tau.share, k),
+											_id);
+					}
+				} else {
+					level.duplicates++;
+				}
+			}
+		}
+		if (--level_size == 0) {
+			level_size = R.size() - next;
+			this->end_level(profile, level, level_watch);
+		}
+		if (progress != nullptr
+				&& (level_size == R.size() - next
+						|| level.expanded % Progress::PUBLISH_PERIOD == 0)) {
+			progress->states.store(R.size(), std::memory_order_relaxed);
+			progress->frontier.store(R.size() - next,
+					std::memory_order_relaxed);
+			progress->depth.store(level.depth, std::memory_order_relaxed);
+			progress->reached_ts.store(nreached, std::memory_order_relaxed);
+		}
+	}
+
+	Search_Result result;
+	result.reachable.assign(model.S(), vector<bool>(model.L(), false));
+	for (size_t i = 0; i < R.size(); ++i)
+		for (Local_State l = 0; l < model.L(); ++l)
+			if (R[i].counters[l] > 0)
+				result.reachable[R[i].share][l] = true;
+	result.reachable[init_ts.share][init_ts.local] = true;
+	result.states = R.size();
+	result.mode = State_Store_Base::EXACT;
+	result.stopped = stopped;
+	if (collect != nullptr && complete)
+		for (size_t i = 0; i < R.size(); ++i) {
+			collect->emplace_back(R[i].share);
+			const size_t size = collect->size();
+			collect->emplace_back(0);
+			for (Local_State l = 0; l < model.L(); ++l)
+				if (R[i].counters[l] > 0) {
+					collect->emplace_back(l);
+					collect->emplace_back(R[i].counters[l]);
+				}
+			(*collect)[size] = (collect->size() - size - 1) / 2;
+		}
+	if (stats != nullptr) {
+		profile.time = watch.elapsed();
+		profile.states = R.size();
+		profile.store = "dense";
+		profile.counter = sizeof(C);
+		profile.bytes.emplace_back("visited_set", R.bytes());
+		profile.bytes.emplace_back("TTD", model.bytes());
+		if (trace != nullptr)
+			profile.bytes.emplace_back("trace", trace->bytes());
+		stats->add_phase("search", profile.time);
+		stats->add_search(profile);
+	}
+	return result;
+}
+
+/**
+ * @brief a level-synchronous forward search over packed states, see
+ *        Packed_State. The visited set is a sorted array. Each BFS level
+ *        collects the successors of its states in contiguous buffers, sorts
+ *        them by radix sort and drops duplicates, and then merges them with
+ *        the visited set in one streaming pass; the states new to the
+ *        visited set form the next level. Every memory access but the
+ *        lookups of the transitions is sequential. A large level is split
+ *        among nthreads threads, each expanding and sorting its part. It
+ *        reaches the same states as standard_FWS.
+ * @param n: number of threads at the initial states
+ * @param s: maximum number of spawn transition could be fired
+ * @param packing
+ * @return Search_Result
+ */
+template<size_t K>
+Search_Result FWS::packed_FWS(const size_p& n, const size_p& s,
+		const Packing& packing) {
+	Stopwatch watch, level_watch;
+	Search_Profile profile(n, s);
+	Level_Profile level = { 0, 0, 0, 0, 0, 0 };
+	vector<bool> reached;
+	ulong nreached = this->begin_search(n, s, reached);
+	const uint threads =
+			nthreads > 0 ?
+					nthreads : std::max(1u, std::thread::hardware_concurrency());
+
+	const auto init = packing.pack<K>(init_ts, n);
+	vector<Packed_State<K>> visited(1, init), frontier(1, init), merged;
+	if (dump != nullptr)
+		dump->add(packing.unpack(init));
+	vector<vector<Packed_State<K>>> buffers(threads), tmps(threads);
+	while (!frontier.empty()) {
+		if (known != nullptr && nreached == reached.size()) {
+			complete = false;
+			break;
+		}
+		if (this->should_stop(visited.size(), true))
+			break;
+		if (frontier.size() > profile.peak_frontier)
+			profile.peak_frontier = frontier.size();
+		level.expanded = frontier.size();
+
+		/// expand and sort: part t of the level on thread t
+		const uint k = frontier.size() >= PARALLEL_LEVEL ? threads : 1;
+		vector<Level_Profile> counts(k, Level_Profile { 0, 0, 0, 0, 0, 0 });
+		auto part = [&](const uint& t) {
+			const size_t size = frontier.size();
+			this->expand_level(packing, frontier, size * t / k,
+					size * (t + 1) / k, ulong(n) + s, buffers[t], counts[t]);
+			radix_sort(buffers[t], tmps[t]);
+			buffers[t].erase(std::unique(buffers[t].begin(), buffers[t].end()),
+					buffers[t].end());
+		};
+		vector<std::thread> workers;
+		for (uint t = 1; t < k; ++t)
+			workers.emplace_back(part, t);
+		part(0);
+		for (auto& w : workers)
+			w.join();
+		for (const auto& c : counts)
+			level.edges += c.edges, level.spawns += c.spawns;
+
+		/// merge the sorted parts with the visited set, in one pass
+		merged.clear();
+		merged.reserve(visited.size() + frontier.size());
+		frontier.clear();
+		vector<size_t> heads(k, 0);
+		auto iv = visited.begin();
+		while (true) {
+			const Packed_State<K>* next = nullptr;
+			for (uint t = 0; t < k; ++t)
+				if (heads[t] < buffers[t].size()
+						&& (next == nullptr || buffers[t][heads[t]] < *next))
+					next = &buffers[t][heads[t]];
+			if (next == nullptr)
+				break;
+			const Packed_State<K> g = *next;
+			for (uint t = 0; t < k; ++t)
+				if (heads[t] < buffers[t].size() && buffers[t][heads[t]] == g)
+					++heads[t];
+			while (iv != visited.end() && *iv < g)
+				merged.emplace_back(*iv++);
+			if (iv != visited.end() && *iv == g)
+				continue;
+			if (this->full(visited.size() + frontier.size()))
+				break;
+			merged.emplace_back(g);
+			frontier.emplace_back(g);
+		}
+		merged.insert(merged.end(), iv, visited.end());
+		visited.swap(merged);
+		level.duplicates = level.edges - frontier.size();
+
+		if (dump != nullptr || !reached.empty()) {
+			for (const auto& g : frontier) {
+				const auto u = packing.unpack(g);
+				if (dump != nullptr)
+					dump->add(u);
+				for (const auto& p : u.locals) {
+					if (reached.empty())
+						break;
+					auto ts = model.index(Thread_State(u.share, p.first));
+					if (!reached[ts])
+						reached[ts] = true, ++nreached;
+				}
+			}
+		}
+		this->end_level(profile, level, level_watch);
+		if (progress != nullptr) {
+			progress->states.store(visited.size(), std::memory_order_relaxed);
+			progress->frontier.store(frontier.size(),
+					std::memory_order_relaxed);
+			progress->depth.store(level.depth, std::memory_order_relaxed);
+			progress->reached_ts.store(nreached, std::memory_order_relaxed);
+		}
+	}
+
+	Search_Result result;
+	result.reachable.assign(model.S(), vector<bool>(model.L(), false));
+	for (const auto& g : visited) {
+		const auto share = packing.share(g);
+		for (Local_State l = 0; l < model.L(); ++l)
+			if (packing.get(g, l) > 0)
+				result.reachable[share][l] = true;
+	}
+	result.reachable[init_ts.share][init_ts.local] = true;
+	result.states = visited.size();
+	result.mode = State_Store_Base::EXACT;
+	result.stopped = stopped;
+	if (stats != nullptr) {
+		profile.time = watch.elapsed();
+		profile.states = visited.size();
+		profile.store = "packed";
+		profile.counter = 0;
+		profile.bytes.emplace_back("visited_set",
+				visited.capacity() * sizeof(Packed_State<K> ));
+		profile.bytes.emplace_back("worklist_peak",
+				profile.peak_frontier * sizeof(Packed_State<K> ));
+		profile.bytes.emplace_back("TTD", model.bytes());
+		stats->add_phase("search", profile.time);
+		stats->add_search(profile);
+	}
+	return result;
+}
+
+/**
+ * @brief append the successors of frontier[begin, end) to successors
+ * @param packing
+ * @param frontier
+ * @param begin
+ * @param end
+ * @param bound     : n + s, the most threads of a state
+ * @param successors
+ * @param level     : counts the fired transitions
+ */
+template<size_t K>
+void FWS::expand_level(const Packing& packing,
+		const vector<Packed_State<K>>& frontier, const size_t& begin,
+		const size_t& end, culong& bound, vector<Packed_State<K>>& successors,
+		Level_Profile& level) const {
+	successors.clear();
+	vector<size_p> counters(model.L());
+	for (size_t i = begin; i < end; ++i) {
+		const auto& tau = frontier[i];
+		const Shared_State share = packing.share(tau);
+		ulong threads = 0;
+		for (Local_State l = 0; l < model.L(); ++l)
+			threads += counters[l] = packing.get(tau, l);
+		const ulong budget = bound - threads;
+		for (Local_State l = 0; l < model.L(); ++l) {
+			if (counters[l] == 0)
+				continue;
+			for (const auto& e : model.successors(Thread_State(share, l))) {
+				if (e.is_spawn) {
+					if (budget == 0)
+						continue;
+					level.spawns++;
+				}
+				level.edges++;
+				Packed_State<K> _tau(tau);
+				if (!e.is_spawn)
+					packing.dec(_tau, l);
+				packing.inc(_tau, e.dst.local);
+				packing.set_share(_tau, e.dst.share);
+				successors.emplace_back(_tau);
+			}
+		}
+	}
+}
+
+/**
+ * @brief the moves of a padded state of the seed, see set_seed, whose
+ *        successors the seed may lack. Padded with the extra threads of the
+ *        larger n, idle at the initial local state, a state g of the seed is
+ *        reachable under n and s, and its successors are those of g, padded,
+ *        which the seed holds, but for
+ *          - the moves of an extra thread, if g has no thread at the initial
+ *            local state that could move in its place, and
+ *          - the spawns, if g has fired all seed_s spawns, but the larger s
+ *            allows more.
+ *        A state with either is open: the search fires these moves of it
+ * @param at_init: the threads of the padded state at the initial local state
+ * @param threads: the threads of the padded state
+ * @param n
+ * @param s
+ * @param idle   : whether the moves from the initial local state are new
+ * @param spawns : whether the spawns are new
+ * @return bool: whether the state is open
+ */
+bool FWS::seed_moves(culong& at_init, culong& threads, const size_p& n,
+		const size_p& s, bool& idle, bool& spawns) const {
+	idle = n > seed_n && at_init == ulong(n) - seed_n;
+	spawns = s > seed_s && threads == ulong(n) + seed_s;
+	return idle || spawns;
+}
+
+/**
+ * @brief start a search: publish its setting, and mark the thread states
+ *        known to be reachable
+ * @param n
+ * @param s
+ * @param reached: the reached thread states, kept only if they are needed
+ * @return the number of reached thread states
+ */
+ulong FWS::begin_search(const size_p& n, const size_p& s,
+		vector<bool>& reached) {
+	ulong nreached = 0;
+	if (progress != nullptr)
+		progress->begin_search(n, s);
+	if (progress != nullptr || known != nullptr)
+		reached.resize(model.S() * model.L(), false);
+	if (known != nullptr) {
+		for (size_s s = 0; s < model.S(); ++s)
+			for (size_l l = 0; l < model.L(); ++l)
+				if ((*known)[s][l])
+					reached[model.index(Thread_State(s, l))] = true, ++nreached;
+	}
+	complete = true;
+	stopped.clear();
+	notes.clear();
+	return nreached;
+}
+
+/**
+ * @brief keep the search within the memory budget. As the estimated memory
+ *        of the visited set, the worklist and the trace, if any, approaches
+ *        the budget, switch
+ *        step by step to cheaper representations:
+ *          50%: compress the stored states,
+ *          70%: spill the worklist to disk,
+ *          85%: keep only bitstate hashes of the stored states; from then
+ *               on, the result is approximate.
+ *        Migrating the store needs both representations for a moment,
+ *        hence the early thresholds.
+ * @param R
+ * @param W
+ */
+template<class C>
+void FWS::enforce_budget(State_Store<C>& R, Worklist<C>& W) {
+	const ulong used = R.bytes() + W.bytes()
+			+ (trace != nullptr ? trace->bytes() : 0);
+	string action;
+	if (R.mode() == State_Store_Base::EXACT && used >= max_mem / 2) {
+		action = "compressing stored states";
+		R.compress();
+	} else if (!W.is_spilled() && used >= max_mem / 10 * 7) {
+		action = "spilling the worklist to disk";
+		W.spill();
+	} else if (R.mode() != State_Store_Base::BITSTATE
+			&& used >= max_mem / 100 * 85) {
+		action = "switching to bitstate storage, the result will be approximate";
+		R.to_bitstate(max_mem / 4);
+	} else {
+		return;
+	}
+	notes.emplace_back(
+			"memory budget: " + std::to_string(used / 1024 / 1024) + " of "
+					+ std::to_string(max_mem / 1024 / 1024) + " MB used by "
+					+ std::to_string(R.size()) + " states, " + action);
+}
+
+/**
+ * @brief close the profile of a BFS level and start the next one
+ * @param profile
+ * @param level
+ * @param level_watch
+ */
+void FWS::end_level(Search_Profile& profile, Level_Profile& level,
+		Stopwatch& level_watch) {
+	profile.expanded += level.expanded;
+	profile.edges += level.edges;
+	profile.duplicates += level.duplicates;
+	profile.spawns += level.spawns;
+	if (stats != nullptr) {
+		level.time = level_watch.elapsed();
+		level_watch.restart();
+		profile.levels.emplace_back(level);
+	}
+	level = {level.depth + 1, 0, 0, 0, 0, 0};
+}
+
+/**
+ * @brief estimate the bytes used by the major structures of the search:
+ *        every tree node costs its payload plus the node header
+ * @param profile
+ * @param R
+ */
+template<class C>
+void FWS::measure_bytes(Search_Profile& profile,
+		const State_Store<C>& R) const {
+	const ulong node = 4 * sizeof(void*); /// color, parent, left, right
+	const ulong locals_node = node
+			+ sizeof(typename Locals_T<C>::value_type);
+
+	profile.bytes.emplace_back("visited_set", R.bytes());
+	profile.bytes.emplace_back("worklist_peak",
+			profile.peak_frontier
+					* (sizeof(Global_State_T<C>)
+							+ R.mean_locals() * locals_node));
+
+	profile.bytes.emplace_back("TTD", model.bytes());
+	if (trace != nullptr)
+		profile.bytes.emplace_back("trace", trace->bytes());
+}
+
 /**
  * @brief update counters in local part
  * @param Z  : current locals
@@ -98,7 +1091,8 @@ set<Global_State> FWS::standard_FWS(const size_p& n, const size_p& s) {
  * @param is_spawn:
  * @return local part after updating
  */
-Locals FWS::update_counter(const Locals &Z, const Local_State &dec,
+template<class C>
+Locals_T<C> FWS::update_counter(const Locals_T<C> &Z, const Local_State &dec,
 		const Local_State &inc, const bool &is_spawn) {
 	auto _Z = Z;   /// local copy of Z
 
@@ -129,24 +1123,19 @@ Locals FWS::update_counter(const Locals &Z, const Local_State &dec,
 
 /**
  * @brief extract all reachable thread states from all reachable global states
- * @param R: the set if reachable lobal states
+ * @param R: the store of reachable global states
  * @return S x L bit matrix:
  * 			R[s][l] = true : thread state (s, l) is reachable
  * 			R[s][l] = false: thread state (s, l) is unreachable
  */
-vector<vector<bool>> FWS::extract_reachable_TS(const set<Global_State>& R) {
-	vector<vector<bool>> reached(Thread_State::S,
-			vector<bool>(Thread_State::L, false));
-	reached[0][0] = true;
-	for (auto itau = R.begin(); itau != R.end(); ++itau) {
-		const auto &share = itau->share;
-		for (auto iloc = itau->locals.begin(); iloc != itau->locals.end();
-				++iloc) {
-			const auto &local = iloc->first;
-			if (!reached[share][local])
-				reached[share][local] = true;
-		}
-	}
+template<class C>
+vector<vector<bool>> FWS::extract_reachable_TS(const State_Store<C>& R) {
+	const uint threads =
+			R.size() < PARALLEL_LEVEL ? 1 :
+			nthreads > 0 ?
+					nthreads : std::max(1u, std::thread::hardware_concurrency());
+	auto reached = R.reachable_TS(threads);
+	reached[init_ts.share][init_ts.local] = true;
 	return reached;
 }
 
@@ -158,8 +1147,8 @@ vector<vector<bool>> FWS::extract_reachable_TS(const set<Global_State>& R) {
  */
 void FWS::print_reachable_TS(const vector<vector<bool>>& R) {
 	cout << "Reachable Thread States:\n";
-	for (auto s = 0; s < Thread_State::S; ++s) {
-		for (auto l = 0; l < Thread_State::L; ++l) {
+	for (auto s = 0; s < model.S(); ++s) {
+		for (auto l = 0; l < model.L(); ++l) {
 			if (R[s][l])
 				cout << s << "|" << l << "\n";
 		}
@@ -175,8 +1164,8 @@ void FWS::print_reachable_TS(const vector<vector<bool>>& R) {
  */
 void FWS::print_unreachable_TS(const vector<vector<bool>>& R) {
 	cout << "Unreachable Thread States:\n";
-	for (auto s = 0; s < Thread_State::S; ++s) {
-		for (auto l = 0; l < Thread_State::L; ++l) {
+	for (auto s = 0; s < model.S(); ++s) {
+		for (auto l = 0; l < model.L(); ++l) {
 			if (!R[s][l])
 				cout << s << "|" << l << "\n";
 		}
@@ -184,6 +1173,21 @@ void FWS::print_unreachable_TS(const vector<vector<bool>>& R) {
 	cout << endl;
 }
 
+/**
+ * @brief print whether the result of a search is exact or approximate
+ * @param R
+ */
+void FWS::print_exactness(const Search_Result& R) {
+	if (R.is_exact())
+		cout << "the result is exact (states stored as "
+				<< State_Store_Base::mode_name(R.mode) << ")\n";
+	else
+		cout << "the result is APPROXIMATE: bitstate storage may have missed "
+				"states, so the reachable thread states are an "
+				"under-approximation\n";
+	cout << endl;
+}
+
 /**
  * @brief statistics
  * @param R: S x L bit matrix:
@@ -192,19 +1196,31 @@ void FWS::print_unreachable_TS(const vector<vector<bool>>& R) {
  */
 uint FWS::statistic(const vector<vector<bool>>& R) {
 	uint reach = 0;
-	for (auto s = 0; s < Thread_State::S; ++s) {
-		for (auto l = 0; l < Thread_State::L; ++l) {
+	for (auto s = 0; s < model.S(); ++s) {
+		for (auto l = 0; l < model.L(); ++l) {
 			if (R[s][l])
 				reach++;
 		}
 	}
 	cout << "current # of   reachable Thread States: " << reach << "\n";
 	cout << "current # of unreachable Thread States: "
-			<< (Thread_State::S * Thread_State::L - reach) << "\n";
+			<< (model.S() * model.L() - reach) << "\n";
 	cout << endl;
 	return reach;
 }
 
+template State_Store<uint8_t> FWS::standard_FWS<uint8_t>(const size_p&,
+		const size_p&);
+template State_Store<uint16_t> FWS::standard_FWS<uint16_t>(const size_p&,
+		const size_p&);
+template State_Store<uint32_t> FWS::standard_FWS<uint32_t>(const size_p&,
+		const size_p&);
+template vector<vector<bool>> FWS::extract_reachable_TS<uint32_t>(
+		const State_Store<uint32_t>&);
+template Locals_T<uint32_t> FWS::update_counter<uint32_t>(
+		const Locals_T<uint32_t>&, const Local_State&, const Local_State&,
+		const bool&);
+
 /////////////////////// utilities class ////////////////////////////////
 
 Util::Util() {
@@ -283,6 +1299,21 @@ Thread_State Util::create_thread_state_from_str(const string& s_ts,
 	return Thread_State(std::stoi(share), std::stoi(local));
 }
 
+/**
+ * @brief read a thread transition system from file. As side effects, the
+ *        sizes Thread_State::S, Thread_State::L and the spawn transitions
+ *        Refs::spawntra_TTD are set
+ * @param filename
+ * @return the thread-state transition diagram as an adjacency list
+ */
+adjacency_list Util::read_TTD(const string& filename) {
+	const auto model = Model::load(filename);
+	Thread_State::S = model->S();
+	Thread_State::L = model->L();
+	Refs::spawntra_TTD = model->spawn_adjacency();
+	return model->adjacency();
+}
+
 /**
  * @brief print all of the transitions in the thread-state transition diagram
  * @param adjacency_list
@@ -10,28 +10,228 @@
 
 #include "state.hh"
 #include "refs.hh"
+#include "stats.hh"
+#include "progress.hh"
+#include "store.hh"
+#include "model.hh"
+#include "dense.hh"
+#include "dump.hh"
+#include "trace.hh"
+#include "packed.hh"
+
+#include <csignal>
 
 namespace sura {
 
+/// the outcome of a search, whatever the counter type of its states
+struct Search_Result {
+	vector<vector<bool>> reachable; /// S x L: reachable thread states
+	ulong states;                   /// reachable global states
+	State_Store_Base::Mode mode;    /// representation of the visited set
+	string stopped; /// why the search stopped before its end: "timeout",
+	                /// "state limit" or "interrupt"; empty if it did not.
+	                /// Its reachable thread states are then only those
+	                /// proven reachable so far
+	vector<string> notes; /// what happened along the way, e.g., the
+	                      /// switches of the memory budget, for the
+	                      /// caller to print
+	string summary;       /// the work of the search engine in one line,
+	                      /// printed with --statistic; empty if none
+
+	Search_Result() :
+			states(0), mode(State_Store_Base::EXACT) {
+	}
+
+	inline bool is_exact() const {
+		return mode != State_Store_Base::BITSTATE;
+	}
+};
+
 class FWS {
 public:
-	FWS();
-	FWS(const Thread_State& init_ts, const adjacency_list& TTD);
+	/// how a search represents global states
+	enum Representation {
+		AUTO, DENSE, SPARSE, PACKED, SYMBOLIC
+	};
+
+	FWS(const Thread_State& init_ts, const Model& model);
 	virtual ~FWS();
 
 	void cutoff_detection();
-	set<Global_State> standard_FWS(const size_p& n, const size_p& s);
+	Search_Result reachability_analysis(const size_p& n, const size_p& s);
+	void report(const Search_Result& R);
+	Search_Result explore(const size_p& n, const size_p& s);
+	template<class C>
+	State_Store<C> standard_FWS(const size_p& n, const size_p& s);
+
+	/// attach statistics to record the profile of every search
+	void set_statistics(Statistics* stats) {
+		this->stats = stats;
+	}
+	/// attach a progress reporter which samples every search
+	void set_progress(Progress* progress) {
+		this->progress = progress;
+	}
+
+	/// bound the memory of every search, in bytes (0: unlimited)
+	void set_memory_budget(culong& max_mem) {
+		this->max_mem = max_mem;
+	}
+
+	/// write every reached global state to dump (nullptr: none)
+	void set_dump(Dump_Writer* dump) {
+		this->dump = dump;
+	}
+
+	/// record the parent of every reached state in trace (nullptr: none)
+	void set_trace(Trace* trace) {
+		this->trace = trace;
+	}
+
+	/// force dense, sparse, packed or symbolic states, see explore
+	void set_representation(const Representation& repr) {
+		this->repr = repr;
+	}
+
+	/// the threads expanding a level of a packed search (0: one per core)
+	void set_threads(const uint& nthreads) {
+		this->nthreads = nthreads;
+	}
+
+	/// the worker processes of a sharded search (1: the search is not
+	/// sharded), see sharded_FWS
+	void set_processes(const uint& processes) {
+		this->processes = processes;
+	}
+
+	/// stop every following search once this many seconds passed since
+	/// the call, or once it stored max_states states (0: no limit). A
+	/// stopped search returns the states reached so far, see Search_Result
+	void set_limits(const double& seconds, culong& max_states);
+	/// let SIGINT and SIGTERM stop every following dense, sparse or packed
+	/// search as set_limits does. The handlers are installed only while a
+	/// search runs, and those before are restored after, so a signal
+	/// outside one ends the process as usual. Only an interruptible search
+	/// reads the signal flag, which is shared by all instances: set it on
+	/// one search at a time
+	void set_interruptible(const bool& interruptible) {
+		this->interruptible = interruptible;
+	}
+
+	/// gallop over the bounds of cutoff_detection instead of scanning them
+	void set_gallop_cutoff(const bool& gallop) {
+		this->gallop_cutoff = gallop;
+	}
+
+	/// thread states known to be reachable in every following search, e.g.,
+	/// from a search with smaller bounds. A search stops as soon as it and
+	/// these together cover all thread states. Pass nullptr to unset.
+	void set_known_reachable(const vector<vector<bool>>* known) {
+		this->known = known;
+	}
+	/// start every following search from seed, the reachable global states
+	/// of the same initial thread state under bounds n and s no larger than
+	/// those of the search, in the words of set_collect; see seed_moves.
+	/// Only dense and sparse searches without trace take a seed. Pass
+	/// nullptr to unset.
+	void set_seed(const vector<size_p>* seed, const size_p& n,
+			const size_p& s) {
+		this->seed = seed;
+		this->seed_n = n;
+		this->seed_s = s;
+	}
+	/// collect the reachable global states of every following dense or
+	/// sparse search into states, if it stores them exactly and runs to
+	/// its end; states is left empty otherwise. A state takes the words:
+	/// its shared state, the number m of local states with a thread, and m
+	/// pairs (local state, counter). Pass nullptr to unset.
+	void set_collect(vector<size_p>* states) {
+		this->collect = states;
+	}
+	/// false if the last search stopped early, see set_known_reachable; its
+	/// states are then only a subset of the reachable global states
+	bool is_complete() const {
+		return complete;
+	}
+	/// true if the last search stopped early on a limit or a signal, see
+	/// set_limits
+	bool is_stopped() const {
+		return !stopped.empty();
+	}
+
+	template<class C>
+	vector<vector<bool>> extract_reachable_TS(const State_Store<C>& R);
+	template<class C>
+	static Locals_T<C> update_counter(const Locals_T<C> &Z,
+			const Local_State &dec, const Local_State &inc,
+			const bool &is_spawn);
 
 private:
 	Thread_State init_ts;
-	adjacency_list TTD;
-	vector<vector<bool>> extract_reachable_TS(const set<Global_State>& R);
+	const Model& model;
+	Statistics* stats;
+	Progress* progress;
+	ulong max_mem;
+	const vector<vector<bool>>* known;
+	bool complete;
+	const vector<size_p>* seed;
+	size_p seed_n;
+	size_p seed_s;
+	vector<size_p>* collect;
+	Representation repr;
+	Dump_Writer* dump;
+	Trace* trace;
+	uint nthreads;
+	uint processes;
+	bool gallop_cutoff;
+	double timeout;
+	ulong max_states;
+	std::chrono::steady_clock::time_point deadline;
+	bool interruptible;
+	string stopped; /// see Search_Result
+	vector<string> notes; /// see Search_Result
+	static volatile std::sig_atomic_t interrupted; /// see set_interruptible
+	static void interrupt(int signal);
+
+	/// how many expansions the search does between two budget checks
+	static const ulong BUDGET_PERIOD = 1024;
+	/// the smallest level a packed search expands on several threads
+	static const ulong PARALLEL_LEVEL = 4096;
+
+	template<class C>
+	Search_Result explore(const size_p& n, const size_p& s);
+	template<class C, size_l N>
+	Search_Result dense_FWS(const size_p& n, const size_p& s);
+	template<size_t K>
+	Search_Result packed_FWS(const size_p& n, const size_p& s,
+			const Packing& packing);
+	template<size_t K>
+	Search_Result sharded_FWS(const size_p& n, const size_p& s,
+			const Packing& packing);
+	Search_Result symbolic_FWS(const size_p& n, const size_p& s);
+	template<size_t K>
+	void expand_level(const Packing& packing, const vector<Packed_State<K>>& frontier,
+			const size_t& begin, const size_t& end, culong& bound,
+			vector<Packed_State<K>>& successors, Level_Profile& level) const;
+	ulong begin_search(const size_p& n, const size_p& s,
+			vector<bool>& reached);
+	bool should_stop(culong& states, const bool& check_clock);
+	bool full(culong& states);
+	bool seed_moves(culong& at_init, culong& threads, const size_p& n,
+			const size_p& s, bool& idle, bool& spawns) const;
+	template<class C>
+	void enforce_budget(State_Store<C>& R, Worklist<C>& W);
+	void end_level(Search_Profile& profile, Level_Profile& level,
+			Stopwatch& level_watch);
+	template<class C>
+	void measure_bytes(Search_Profile& profile, const State_Store<C>& R) const;
+	uint probe_cutoff(const size_p& k);
+	void report_stopped(const Search_Result& R);
+	void print_notes(const Search_Result& R);
+	void print_exactness(const Search_Result& R);
 	void print_reachable_TS(const vector<vector<bool>>& R);
 	void print_unreachable_TS(const vector<vector<bool>>& R);
 	uint statistic(const vector<vector<bool>>& R);
-
-	Locals update_counter(const Locals &Z, const Local_State &dec,
-			const Local_State &inc, const bool &is_spawn);
 };
 
 class Util {
@@ -46,6 +246,7 @@ public:
 			const char& delim = '|');
 	static Global_State create_global_state_from_str(const string& s_gs,
 			const char& delim = '|');
+	static adjacency_list read_TTD(const string& filename);
 	static void print_adj_list(const adjacency_list& adj_list, ostream& out =
 			cout);
 	static bool is_spawn_transition(const Thread_State& src,
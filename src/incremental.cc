@@ -0,0 +1,264 @@
+/*
+ * incremental.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "incremental.hh"
+
+namespace sura {
+
+/**
+ * @brief apply an edit script to a model
+ * @param before: the model the saved states were computed for
+ * @param edits : no transition may be added twice, or removed if absent
+ */
+Incremental::Incremental(const Model& before, const vector<Model_Edit>& edits) :
+		before(before), nsaved(0), naffected(0), nseeds(0), nexpanded(0) {
+	adjacency_list TTD = before.adjacency(), spawn_TTD =
+			before.spawn_adjacency();
+	for (const auto& e : edits) {
+		if (!before.contains(e.src) || !before.contains(e.dst))
+			throw CONTROL::Error("edit: thread state out of range");
+		auto& dsts = TTD[e.src];
+		auto& spawns = spawn_TTD[e.src];
+		const auto id = std::find(dsts.begin(), dsts.end(), e.dst);
+		const auto is = std::find(spawns.begin(), spawns.end(), e.dst);
+		const bool exists = id != dsts.end()
+				&& (is != spawns.end()) == e.is_spawn;
+		if (e.is_add) {
+			if (id != dsts.end())
+				throw CONTROL::Error("edit: the added transition exists");
+			dsts.emplace_back(e.dst);
+			if (e.is_spawn)
+				spawns.emplace_back(e.dst);
+			added.emplace_back(e);
+		} else {
+			if (!exists)
+				throw CONTROL::Error("edit: the removed transition is absent");
+			dsts.erase(id);
+			if (e.is_spawn)
+				spawns.erase(is);
+			removed.emplace_back(e);
+		}
+	}
+	after = std::make_shared<const Model>(before.S(), before.L(), TTD,
+			spawn_TTD);
+}
+
+/**
+ * @brief read an edit script. Every line adds or removes a transition,
+ *        written as in a .tts file:
+ *          + s1 l1 -> s2 l2
+ *          - s1 l1 +> s2 l2
+ *          ...
+ *        where "#" starts a comment
+ * @param in
+ * @return vector<Model_Edit>
+ */
+vector<Model_Edit> Incremental::read_edits(istream& in) {
+	std::stringstream no_comment;
+	CONTROL::remove_comments(in, no_comment, "#");
+	vector<Model_Edit> edits;
+	string op, sep;
+	ushort s1, l1, s2, l2;
+	while (no_comment >> op) {
+		if (!(no_comment >> s1 >> l1 >> sep >> s2 >> l2))
+			throw CONTROL::Error("edit: incomplete transition");
+		if ((op != "+" && op != "-") || (sep != "->" && sep != "+>"))
+			throw CONTROL::Error("edit: illegal line");
+		edits.emplace_back(op == "+", Thread_State(s1, l1),
+				Thread_State(s2, l2), sep == "+>");
+	}
+	return edits;
+}
+
+/**
+ * @brief the reachable global states of the edited model, for the setting
+ *        of the previous run: its initial state, n and s
+ * @param previous: the reachable states of the model before the edit, all
+ *                  of them, see Dump_Header::complete
+ * @param dump    : receives the new reachable states, or nullptr
+ * @return Search_Result
+ */
+Search_Result Incremental::run(Dump_Reader& previous, Dump_Writer* dump) {
+	const auto& h = previous.header();
+	if (h.S != before.S() || h.L != before.L())
+		throw CONTROL::Error("the saved states are not of this model");
+	if (!h.complete)
+		throw CONTROL::Error(
+				"the saved states are not all reachable states: their search stopped early or stored them inexactly");
+	const Packing packing(before.S(), before.L(), ulong(h.n) + h.s);
+	switch (packing.words()) {
+	case 1:
+		return this->run<1>(previous, dump, packing);
+	case 2:
+		return this->run<2>(previous, dump, packing);
+	case 3:
+		return this->run<3>(previous, dump, packing);
+	case 4:
+		return this->run<4>(previous, dump, packing);
+	default:
+		throw CONTROL::Error("too many local states for packed states");
+	}
+}
+
+template<size_t K>
+Search_Result Incremental::run(Dump_Reader& previous, Dump_Writer* dump,
+		const Packing& packing) {
+	const auto& h = previous.header();
+	const ulong bound = ulong(h.n) + h.s;
+	const size_l L = before.L();
+	auto threads = [&](const Packed_State<K>& g) {
+		ulong k = 0;
+		for (Local_State l = 0; l < L; ++l)
+			k += packing.get(g, l);
+		return k;
+	};
+	/// can the thread at src fire e in g?
+	auto enabled = [&](const Packed_State<K>& g, const Thread_State& src,
+			const bool& is_spawn) {
+		return packing.share(g) == src.share && packing.get(g, src.local) > 0
+				&& (!is_spawn || threads(g) < bound);
+	};
+	auto fire = [&](Packed_State<K> g, const Local_State& src,
+			const Thread_State& dst, const bool& is_spawn) {
+		if (!is_spawn)
+			packing.dec(g, src);
+		packing.inc(g, dst.local);
+		packing.set_share(g, dst.share);
+		return g;
+	};
+
+	/// the saved states
+	Packed_Set<K> R;
+	Global_State u;
+	while (previous.next(u)) {
+		ulong k = 0;
+		for (const auto& p : u.locals)
+			k += p.second;
+		if (u.share >= before.S() || k > bound)
+			throw CONTROL::Error("a saved state is out of range");
+		const auto g = packing.pack<K>(u);
+		R.insert(g, hash(g));
+	}
+	nsaved = R.size();
+
+	/// A: the saved states reachable from a target of a removed transition
+	/// by a path that avoids the initial state, which no edit makes
+	/// unreachable: a state reached from it again is reachable without the
+	/// removed transition before
+	const auto init = packing.pack<K>(h.init, h.n);
+	vector<bool> affected(R.size(), false);
+	vector<size_t> stack;
+	auto affect = [&](const Packed_State<K>& g) {
+		const size_t i = R.find(g, hash(g));
+		if (i != Packed_Set<K>::NONE && !affected[i] && !(g == init))
+			affected[i] = true, stack.emplace_back(i);
+	};
+	if (!removed.empty())
+		for (size_t i = 0; i < R.size(); ++i)
+			for (const auto& e : removed)
+				if (enabled(R[i], e.src, e.is_spawn))
+					affect(fire(R[i], e.src.local, e.dst, e.is_spawn));
+	while (!stack.empty()) {
+		const Packed_State<K> x = R[stack.back()];
+		stack.pop_back();
+		const Shared_State share = packing.share(x);
+		for (Local_State l = 0; l < L; ++l) {
+			if (packing.get(x, l) == 0)
+				continue;
+			for (const auto& e : before.successors(Thread_State(share, l)))
+				if (enabled(x, Thread_State(share, l), e.is_spawn))
+					affect(fire(x, l, e.dst, e.is_spawn));
+		}
+	}
+	naffected = std::count(affected.begin(), affected.end(), true);
+
+	/// the kept states, and the states to restart from
+	Packed_Set<K> V;
+	for (size_t i = 0; i < R.size(); ++i)
+		if (!affected[i])
+			V.insert(R[i], hash(R[i]));
+	const size_t kept = V.size();
+	auto is_kept = [&](const Packed_State<K>& g) {
+		const size_t i = R.find(g, hash(g));
+		return i != Packed_Set<K>::NONE && !affected[i];
+	};
+	if (!is_kept(init))
+		V.insert(init, hash(init));
+	if (!removed.empty()) { /// the affected states a kept state enters
+		vector<vector<Model_Edit>> into(before.S()); /// by dst.share
+		for (size_s s = 0; s < after->S(); ++s)
+			for (size_l l = 0; l < L; ++l)
+				for (const auto& e : after->successors(Thread_State(s, l)))
+					into[e.dst.share].emplace_back(true, Thread_State(s, l),
+							e.dst, e.is_spawn);
+		for (size_t i = 0; i < R.size(); ++i) {
+			if (!affected[i])
+				continue;
+			const auto& a = R[i];
+			for (const auto& e : into[packing.share(a)]) {
+				if (packing.get(a, e.dst.local) == 0)
+					continue;
+				auto pre = a;
+				packing.dec(pre, e.dst.local);
+				if (e.is_spawn) { /// the spawner stays at src
+					if (packing.get(pre, e.src.local) == 0)
+						continue;
+				} else {
+					packing.inc(pre, e.src.local);
+				}
+				packing.set_share(pre, e.src.share);
+				if (is_kept(pre)) {
+					V.insert(a, hash(a));
+					break;
+				}
+			}
+		}
+	}
+	for (const auto& e : added) /// the successors of kept states under
+		for (size_t i = 0; i < kept; ++i) /// the added transitions
+			if (enabled(V[i], e.src, e.is_spawn)) {
+				const auto g = fire(V[i], e.src.local, e.dst, e.is_spawn);
+				V.insert(g, hash(g));
+			}
+	nseeds = V.size() - kept;
+
+	/// a forward search of the edited model from the seeds
+	nexpanded = 0;
+	for (size_t next = kept; next < V.size(); ++next) {
+		const Packed_State<K> tau = V[next]; /// a copy: V may grow
+		++nexpanded;
+		const Shared_State share = packing.share(tau);
+		const bool can_spawn = threads(tau) < bound;
+		for (Local_State l = 0; l < L; ++l) {
+			if (packing.get(tau, l) == 0)
+				continue;
+			for (const auto& e : after->successors(Thread_State(share, l))) {
+				if (e.is_spawn && !can_spawn)
+					continue;
+				const auto g = fire(tau, l, e.dst, e.is_spawn);
+				V.insert(g, hash(g));
+			}
+		}
+	}
+
+	Search_Result result;
+	result.reachable.assign(after->S(), vector<bool>(L, false));
+	for (size_t i = 0; i < V.size(); ++i) {
+		const auto share = packing.share(V[i]);
+		for (Local_State l = 0; l < L; ++l)
+			if (packing.get(V[i], l) > 0)
+				result.reachable[share][l] = true;
+		if (dump != nullptr)
+			dump->add(packing.unpack(V[i]));
+	}
+	result.reachable[h.init.share][h.init.local] = true;
+	result.states = V.size();
+	result.mode = State_Store_Base::EXACT;
+	return result;
+}
+
+} /* namespace sura */
@@ -0,0 +1,91 @@
+/*
+ * incremental.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef INCREMENTAL_HH_
+#define INCREMENTAL_HH_
+
+#include "fws.hh"
+
+namespace sura {
+
+/// a line of an edit script: a transition added to or removed from a model
+struct Model_Edit {
+	bool is_add;
+	Thread_State src;
+	Thread_State dst;
+	bool is_spawn;
+
+	Model_Edit(const bool& is_add, const Thread_State& src,
+			const Thread_State& dst, const bool& is_spawn) :
+			is_add(is_add), src(src), dst(dst), is_spawn(is_spawn) {
+	}
+};
+
+/**
+ * @brief re-verification after an edit of the model: the reachable global
+ *        states of the edited model, computed from those of the model before
+ *        the edit, as saved in a dump.
+ *        A removed transition can only make states unreachable that are
+ *        reachable from a state it entered: that region A is the closure of
+ *        the removed transitions' targets under the old transitions, short
+ *        of the initial state, and every other saved state is reachable
+ *        without them, so it is kept.
+ *        The search then restarts from the states of A that a kept state
+ *        still enters, found by computing their predecessors, and from the
+ *        successors of kept states under the added transitions. Kept states
+ *        are never expanded, and the search visits only what is new or in A.
+ */
+class Incremental {
+public:
+	Incremental(const Model& before, const vector<Model_Edit>& edits);
+	~Incremental() {
+	}
+
+	static vector<Model_Edit> read_edits(istream& in);
+
+	/// the edited model
+	inline const Model& model() const {
+		return *after;
+	}
+
+	Search_Result run(Dump_Reader& previous, Dump_Writer* dump = nullptr);
+
+	/// the saved states of the last run
+	inline ulong saved() const {
+		return nsaved;
+	}
+	/// the saved states a removed transition may have made unreachable
+	inline ulong affected() const {
+		return naffected;
+	}
+	/// the states the search of the last run restarted from
+	inline ulong seeds() const {
+		return nseeds;
+	}
+	/// the states the search of the last run expanded
+	inline ulong expanded() const {
+		return nexpanded;
+	}
+
+private:
+	const Model& before;
+	shared_ptr<const Model> after;
+	vector<Model_Edit> added;
+	vector<Model_Edit> removed;
+	ulong nsaved;
+	ulong naffected;
+	ulong nseeds;
+	ulong nexpanded;
+
+	template<size_t K>
+	Search_Result run(Dump_Reader& previous, Dump_Writer* dump,
+			const Packing& packing);
+};
+
+} /* namespace sura */
+
+#endif /* INCREMENTAL_HH_ */
@@ -0,0 +1,240 @@
+/*
+ * jobs.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "jobs.hh"
+#include "fws.hh"
+
+#include <cerrno>
+#include <csignal>
+#include <iomanip>
+#include <thread>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace sura {
+
+string Job_Outcome::status_name(const Status& status) {
+	switch (status) {
+	case OK:
+		return "ok";
+	case TIMEOUT:
+		return "timeout";
+	case MEMOUT:
+		return "memout";
+	default:
+		return "failed";
+	}
+}
+
+/**
+ * @param workers: number of jobs run at a time (0: one per core)
+ * @param mem_mb : memory limit of a job in MB (0: unlimited)
+ * @param seconds: wall-clock limit of a job (0: unlimited)
+ */
+Job_Runner::Job_Runner(const uint& workers, culong& mem_mb,
+		const double& seconds) :
+		workers(workers > 0 ?
+				workers : std::max(1u, std::thread::hardware_concurrency())), mem_mb(
+				mem_mb), seconds(seconds) {
+}
+
+/**
+ * @brief read a manifest, one job per line: <model> <initial thread state>
+ *        <n> <s>, e.g., "models/a.tts 0|0 3 2". "#" starts a comment
+ * @param in
+ * @return the jobs in the order of the manifest
+ */
+vector<Job> Job_Runner::read_jobs(istream& in) {
+	std::stringstream no_comment;
+	CONTROL::remove_comments(in, no_comment, "#");
+	vector<Job> jobs;
+	string model, init;
+	long n, s;
+	while (no_comment >> model) {
+		if (!(no_comment >> init >> n >> s) || n < 0 || s < 0
+				|| ulong(n) + s > UINT32_MAX) /// see counter_width
+			throw CONTROL::Error("illegal job for model " + model);
+		jobs.emplace_back(model,
+				Query(Util::create_thread_state_from_str(init), n, s));
+	}
+	return jobs;
+}
+
+/**
+ * @brief run all jobs, at most workers at a time, in the order of the
+ *        manifest
+ * @param jobs
+ * @return the outcome of every job
+ */
+vector<Job_Outcome> Job_Runner::run(const vector<Job>& jobs) {
+	map<string, shared_ptr<const Model>> models; /// nullptr: unparsable
+	for (const auto& job : jobs) {
+		if (models.count(job.model) > 0)
+			continue;
+		shared_ptr<const Model> model;
+		try {
+			model = Model::load(job.model);
+		} catch (const CONTROL::Error& error) {
+			cerr << job.model << ": ";
+			error.print(cerr);
+		}
+		models.emplace(job.model, model);
+	}
+
+	struct Running {
+		size_t job;
+		int fd;
+		Stopwatch watch;
+		bool killed;
+	};
+	vector<Job_Outcome> outcomes(jobs.size());
+	map<pid_t, Running> running;
+	cout.flush(); /// or the jobs would print the buffered output again
+	cerr.flush();
+	size_t next = 0;
+	while (next < jobs.size() || !running.empty()) {
+		while (running.size() < workers && next < jobs.size()) {
+			const size_t j = next++;
+			const auto& model = models[jobs[j].model];
+			if (!model)
+				continue; /// FAILED
+			int fds[2];
+			if (::pipe(fds) != 0)
+				throw CONTROL::Error("cannot create a pipe");
+			const pid_t pid = ::fork();
+			if (pid < 0) {
+				::close(fds[0]);
+				::close(fds[1]);
+				throw CONTROL::Error("cannot fork a job process");
+			}
+			if (pid == 0) {
+				::close(fds[0]);
+				this->run_job(model, jobs[j].query, fds[1]);
+			}
+			::close(fds[1]);
+			running.emplace(pid, Running { j, fds[0], Stopwatch(), false });
+		}
+		if (running.empty())
+			continue; /// the remaining jobs' models are unparsable
+
+		int status;
+		struct rusage usage;
+		pid_t pid;
+		do {
+			pid = ::wait4(-1, &status, WNOHANG, &usage);
+		} while (pid < 0 && errno == EINTR);
+		if (pid < 0)
+			throw CONTROL::Error("cannot wait for a job process");
+		if (pid == 0) {
+			for (auto& r : running)
+				if (!r.second.killed && seconds > 0
+						&& r.second.watch.elapsed() > seconds) {
+					::kill(r.first, SIGKILL);
+					r.second.killed = true;
+				}
+			::usleep(10000);
+			continue;
+		}
+
+		const auto ir = running.find(pid);
+		if (ir == running.end())
+			continue;
+		auto& o = outcomes[ir->second.job];
+		o.seconds = ir->second.watch.elapsed();
+		o.peak_kb = usage.ru_maxrss;
+		if (ir->second.killed)
+			o.status = Job_Outcome::TIMEOUT;
+		else if (WIFEXITED(status) && WEXITSTATUS(status) == 3)
+			o.status = Job_Outcome::MEMOUT;
+		else if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+			char line[128] = { 0 };
+			const ssize_t k = ::read(ir->second.fd, line, sizeof(line) - 1);
+			int exact = 0;
+			if (k > 0
+					&& sscanf(line, "%u %lu %d", &o.reachable, &o.states,
+							&exact) == 3) {
+				o.exact = exact != 0;
+				o.status = Job_Outcome::OK;
+			}
+		}
+		::close(ir->second.fd);
+		running.erase(ir);
+	}
+	return outcomes;
+}
+
+/**
+ * @brief the body of a job's process: answer q under the limits, write the
+ *        answer to fd and exit: 0 if answered, 3 if out of memory, 1 else
+ * @param model
+ * @param q
+ * @param fd
+ */
+void Job_Runner::run_job(const shared_ptr<const Model>& model,
+		const Query& q, const int& fd) const {
+	int code = 0;
+	try {
+		if (mem_mb > 0) {
+			struct rlimit limit;
+			limit.rlim_cur = limit.rlim_max = mem_mb * 1024 * 1024;
+			if (::setrlimit(RLIMIT_AS, &limit) != 0)
+				::_exit(1);
+		}
+		const auto R = Engine(model).query(q);
+		uint reachable = 0;
+		for (size_s s = 0; s < model->S(); ++s)
+			for (size_l l = 0; l < model->L(); ++l)
+				if (R.reachable[s][l])
+					++reachable;
+		const string line = std::to_string(reachable) + " "
+				+ std::to_string(R.states) + " " + (R.exact ? "1" : "0")
+				+ "\n";
+		if (::write(fd, line.data(), line.size()) != ssize_t(line.size()))
+			code = 1;
+	} catch (const std::bad_alloc&) {
+		code = 3;
+	} catch (...) {
+		code = 1;
+	}
+	::_exit(code);
+}
+
+/**
+ * @brief write the outcome of every job, tab separated, and a summary line
+ * @param jobs
+ * @param outcomes
+ * @param out
+ */
+void Job_Runner::report(const vector<Job>& jobs,
+		const vector<Job_Outcome>& outcomes, ostream& out) const {
+	out << "model\tinit\tn\ts\tstatus\treachable_ts\tstates\tseconds\tpeak_kb\n";
+	map<Job_Outcome::Status, uint> counts;
+	double total = 0;
+	for (size_t j = 0; j < jobs.size(); ++j) {
+		const auto& q = jobs[j].query;
+		const auto& o = outcomes[j];
+		++counts[o.status];
+		total += o.seconds;
+		out << jobs[j].model << "\t" << q.init.share << "|" << q.init.local
+				<< "\t" << q.n << "\t" << q.s << "\t"
+				<< Job_Outcome::status_name(o.status)
+				<< (o.status == Job_Outcome::OK && !o.exact ?
+						" (approximate)" : "") << "\t" << o.reachable << "\t"
+				<< o.states << "\t" << std::fixed << std::setprecision(3)
+				<< o.seconds << std::defaultfloat << "\t" << o.peak_kb << "\n";
+	}
+	out << "# " << jobs.size() << " jobs on " << workers << " workers: "
+			<< counts[Job_Outcome::OK] << " ok, "
+			<< counts[Job_Outcome::TIMEOUT] << " timeout, "
+			<< counts[Job_Outcome::MEMOUT] << " memout, "
+			<< counts[Job_Outcome::FAILED] << " failed, " << std::fixed
+			<< std::setprecision(3) << total << std::defaultfloat
+			<< " job seconds" << endl;
+}
+
+} /* namespace sura */
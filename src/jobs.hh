@@ -0,0 +1,77 @@
+/*
+ * jobs.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef JOBS_HH_
+#define JOBS_HH_
+
+#include "engine.hh"
+
+namespace sura {
+
+/// a line of a manifest: a query on a model file
+struct Job {
+	string model;
+	Query query;
+
+	Job(const string& model, const Query& query) :
+			model(model), query(query) {
+	}
+};
+
+/// how a job ended
+struct Job_Outcome {
+	enum Status {
+		OK, TIMEOUT, MEMOUT, FAILED
+	};
+
+	Status status;
+	uint reachable; /// reachable thread states
+	ulong states;   /// reachable global states
+	bool exact;
+	double seconds;
+	ulong peak_kb;  /// peak resident memory of the job's process
+
+	Job_Outcome() :
+			status(FAILED), reachable(0), states(0), exact(true), seconds(0), peak_kb(
+					0) {
+	}
+
+	static string status_name(const Status& status);
+};
+
+/**
+ * @brief run the jobs of a manifest on a pool of worker processes, each job
+ *        in a process of its own, under a memory limit (RLIMIT_AS) and a
+ *        wall-clock limit: a job that exceeds them fails alone, and the
+ *        others go on. Every model file is parsed once, before the first
+ *        fork, so the jobs on one file share its compiled model through
+ *        copy-on-write pages instead of parsing it each.
+ */
+class Job_Runner {
+public:
+	Job_Runner(const uint& workers, culong& mem_mb, const double& seconds);
+	~Job_Runner() {
+	}
+
+	static vector<Job> read_jobs(istream& in);
+
+	vector<Job_Outcome> run(const vector<Job>& jobs);
+	void report(const vector<Job>& jobs, const vector<Job_Outcome>& outcomes,
+			ostream& out) const;
+
+private:
+	uint workers;
+	ulong mem_mb;
+	double seconds;
+
+	void run_job(const shared_ptr<const Model>& model, const Query& q,
+			const int& fd) const;
+};
+
+} /* namespace sura */
+
+#endif /* JOBS_HH_ */
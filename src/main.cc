@@ -9,6 +9,14 @@
 #include "state.hh"
 #include "input.hh"
 #include "fws.hh"
+#include "bws.hh"
+#include "modular.hh"
+#include "incremental.hh"
+#include "batch.hh"
+#include "jobs.hh"
+#include "daemon.hh"
+
+#include <climits>
 
 using namespace sura;
 
@@ -18,6 +26,7 @@ using namespace sura;
  * @param argv
  * @return int
  * 					 0: successful
+ * 					 2: a search stopped early, see --timeout
  */
 int main(const int argc, const char * const * const argv) {
 	try {
@@ -30,9 +39,72 @@ int main(const int argc, const char * const * const argv) {
 		ins.add_argument("-s", "maximum times of spawn transitions fired", "",
 				"0");
 		ins.add_argument("-i", "the initial thread state", "", "0|0");
+		ins.add_argument("--progress",
+				"print a progress line every this many seconds (0: never)",
+				"", "0");
+		ins.add_argument("--max-mem",
+				"memory budget of the search in MB (0: unlimited)", "", "0");
+		ins.add_argument("--repr", "representation of global states",
+				"auto,dense,sparse,packed,symbolic", "auto");
+		ins.add_argument("--procs",
+				"number of worker processes sharing the search (1: one process)",
+				"", "1");
+		ins.add_argument("--batch",
+				"answer the queries \"<i> <n> <s>\" in this file, one per line",
+				"", "X");
+		ins.add_argument("--jobs",
+				"run the jobs \"<model> <i> <n> <s>\" in this file on a pool of worker processes",
+				"", "X");
+		ins.add_argument("--workers",
+				"number of jobs of --jobs run at a time (0: one per core)", "",
+				"0");
+		ins.add_argument("--job-mem",
+				"memory limit of a job of --jobs in MB (0: unlimited)", "",
+				"0");
+		ins.add_argument("--job-time",
+				"wall-clock limit of a job of --jobs in seconds (0: unlimited)",
+				"", "0");
+		ins.add_argument("--report",
+				"write the report of --jobs to this file (X: standard output)",
+				"", "X");
+		ins.add_argument("--daemon",
+				"serve requests on this UNIX socket, keeping models resident",
+				"", "X");
+		ins.add_argument("--threads",
+				"number of threads serving requests, or expanding a level of --repr packed (0: one per core)", "",
+				"0");
+		ins.add_argument("--connect",
+				"send the request to the daemon on this UNIX socket (default: $ECUT_SOCKET)",
+				"", "X");
+		ins.add_argument("--target",
+				"thread states to cover from any number of threads, by a backward search, e.g., 1|2,0|3 (all: every thread state)",
+				"", "X");
+		ins.add_argument("--dump-states",
+				"write the reachable global states to this file, in binary",
+				"", "X");
+		ins.add_argument("--trace",
+				"print a shortest path to each of these thread states, e.g., 1|2,0|3",
+				"", "X");
+		ins.add_argument("--incremental",
+				"re-verify from the reachable states of this file, written by --dump-states, after the edits of --edits",
+				"", "X");
+		ins.add_argument("--edits",
+				"the transitions added to and removed from the model of -f, e.g., + 0 1 -> 1 2",
+				"", "X");
+		ins.add_argument("--timeout",
+				"stop the search after this many seconds and report what it reached (0: never)",
+				"", "0");
+		ins.add_argument("--max-states",
+				"stop the search once it stored this many global states (0: never)",
+				"", "0");
+		ins.add_argument("--stats-json",
+				"write the statistics of the run as JSON to this file", "",
+				"X");
 
 		ins.add_switch("--tts", "TTS or BP");
 		ins.add_switch("--cutoff", "cutoff detection");
+		ins.add_switch("--gallop-cutoff",
+				"with --cutoff, gallop over the bounds instead of trying them one by one");
 		ins.add_switch("--adj-list", "whether to print the adjacency list");
 		ins.add_switch("--cmd-line", "whether to print the command line");
 		ins.add_switch("--reach-ts",
@@ -42,6 +114,11 @@ int main(const int argc, const char * const * const argv) {
 		ins.add_switch("--statistic",
 				"whether to print the statistic information");
 		ins.add_switch("--all", "whether to print all of the above");
+		ins.add_switch("--shutdown", "shut down the daemon of --connect");
+		ins.add_switch("--modular",
+				"report the thread states a thread-modular over-approximation proves unreachable");
+		ins.add_switch("--confirm",
+				"after --modular, decide the remaining thread states by an exact search");
 
 		try {
 			ins.get_command_line(argc, argv);
@@ -54,21 +131,104 @@ int main(const int argc, const char * const * const argv) {
 			ins.print_command_line(0);
 		}
 
+		const string daemon_socket = ins.arg_value("--daemon");
+		if (daemon_socket != "X") {
+			Daemon daemon(daemon_socket, ins.arg2long("--threads"));
+			daemon.serve();
+			return 0;
+		}
+		string socket = ins.arg_value("--connect");
+		if (socket == "X" && getenv("ECUT_SOCKET") != nullptr)
+			socket = getenv("ECUT_SOCKET");
+		if (ins.arg2bool("--shutdown")) {
+			if (socket == "X")
+				throw CONTROL::Error("--shutdown needs --connect");
+			Client::shutdown(socket);
+			return 0;
+		}
+
+		const string jobs_file = ins.arg_value("--jobs");
+		if (jobs_file != "X") {
+			ifstream in(jobs_file.c_str());
+			if (!in.is_open())
+				throw CONTROL::Error("cannot open " + jobs_file);
+			const auto jobs = Job_Runner::read_jobs(in);
+			in.close();
+			if (ins.arg2long("--workers") < 0 || ins.arg2long("--job-mem") < 0
+					|| atof(ins.arg_value("--job-time").c_str()) < 0)
+				throw CONTROL::Error("the limits of --jobs must be non-negative");
+			Job_Runner runner(ins.arg2long("--workers"),
+					ins.arg2long("--job-mem"),
+					atof(ins.arg_value("--job-time").c_str()));
+			const auto outcomes = runner.run(jobs);
+			const string report = ins.arg_value("--report");
+			if (report == "X") {
+				runner.report(jobs, outcomes, cout);
+			} else {
+				ofstream out(report.c_str());
+				if (!out.is_open())
+					throw CONTROL::Error("cannot open " + report);
+				runner.report(jobs, outcomes, out);
+			}
+			return 0;
+		}
+
 		string filename = ins.arg_value("-f");
 		//FILE_NAME_PREFIX = filename.substr(0, filename.find_last_of("."));
 		const string s_inital = ins.arg_value("-i");
-		const size_p n = atol(ins.arg_value("-n").c_str());
-		const size_p s = atol(ins.arg_value("-s").c_str());
+		const long n_arg = ins.arg2long("-n"), s_arg = ins.arg2long("-s");
+		if (n_arg < 0 || s_arg < 0)
+			throw CONTROL::Error("-n and -s must be non-negative");
+		counter_width(n_arg + s_arg); /// throws if no counter holds n + s
+		const size_p n = n_arg;
+		const size_p s = s_arg;
+		const ulong max_mem = ins.arg2long("--max-mem") * 1024 * 1024;
+		const double timeout = atof(ins.arg_value("--timeout").c_str());
+		const long max_states = ins.arg2long("--max-states");
+		if (timeout < 0 || max_states < 0)
+			throw CONTROL::Error("--timeout and --max-states must be non-negative");
+		const bool is_limited = timeout > 0 || max_states > 0;
 
 		const bool is_cutoff = ins.arg2bool("--cutoff");
+		const string batch_file = ins.arg_value("--batch");
+		const string targets = ins.arg_value("--target");
+		const string dump_file = ins.arg_value("--dump-states");
+		const string traces = ins.arg_value("--trace");
+		const bool is_modular = ins.arg2bool("--modular");
+		const bool is_confirm = ins.arg2bool("--confirm");
+		if ((dump_file != "X" || traces != "X")
+				&& (is_cutoff || batch_file != "X" || targets != "X"
+						|| is_modular))
+			throw CONTROL::Error("--dump-states and --trace need a single search");
+		if (is_confirm && !is_modular)
+			throw CONTROL::Error("--confirm needs --modular");
+		if (is_limited
+				&& (batch_file != "X" || targets != "X"
+						|| (is_modular && !is_confirm)))
+			throw CONTROL::Error(
+					"--timeout and --max-states limit forward searches only");
+		const string previous_file = ins.arg_value("--incremental");
+		const string edits_file = ins.arg_value("--edits");
+		const bool is_incremental = previous_file != "X";
+		if (is_incremental != (edits_file != "X"))
+			throw CONTROL::Error("--incremental and --edits go together");
+		if (is_incremental
+				&& (is_cutoff || batch_file != "X" || targets != "X"
+						|| is_modular || traces != "X" || is_limited))
+			throw CONTROL::Error("--incremental re-verifies a single search");
 
 		Refs::INPUT_IS_TTS = ins.arg2bool("--tts");
 		Refs::OPT_PRT_REACH_TS = ins.arg2bool("--reach-ts");
 		Refs::OPT_PRT_STATISTIC = ins.arg2bool("--statistic");
 		Refs::OPT_PRT_UNREACH_TS = ins.arg2bool("--unreach-ts");
 
+		const string stats_file = ins.arg_value("--stats-json");
+		unique_ptr<Statistics> stats(
+				stats_file == "X" ? nullptr : new Statistics());
+
+		Stopwatch watch;
 		Thread_State init_ts = Util::create_thread_state_from_str(s_inital);
-		adjacency_list original_TTD;
+		shared_ptr<const Model> model;
 		if (filename == "X") {
 			throw CONTROL::Error("no input file");
 		} else {
@@ -78,37 +238,300 @@ int main(const int argc, const char * const * const argv) {
 				filename += ".tts";
 				cout << filename << endl;
 			}
-			ifstream org_in(filename.c_str());
-			CONTROL::remove_comments(org_in, "/tmp/tmp.ttd.no_comment", "#");
-			org_in.close();
-			ifstream new_in("/tmp/tmp.ttd.no_comment");
-			new_in >> Thread_State::S >> Thread_State::L;
-			ushort s1, l1, s2, l2;
-			string sep;
-			while (new_in >> s1 >> l1 >> sep >> s2 >> l2) {
-				if (sep == "->" || sep == "+>") {
-					if (sep == "+>")
-						Refs::spawntra_TTD[Thread_State(s1, l1)].emplace_back(
-								s2, l2);
-					original_TTD[Thread_State(s1, l1)].emplace_back(s2, l2);
-				} else {
-					throw CONTROL::Error("illegal transition");
-				}
+			/// the daemon answers plain analyses; anything else runs here
+			char path[PATH_MAX];
+			if (socket != "X" && !is_cutoff && batch_file == "X"
+					&& targets == "X" && dump_file == "X" && traces == "X"
+					&& !is_modular && !is_incremental && !is_limited
+					&& ins.arg_value("--procs") == "1" && !stats
+					&& ins.arg_value("--repr") == "auto"
+					&& ins.arg_value("--progress") == "0"
+					&& !ins.arg2bool("--adj-list") && !Refs::OPT_PRT_ALL
+					&& realpath(filename.c_str(), path) != nullptr) {
+				Request r;
+				r.model = path;
+				r.query = Query(init_ts, n, s);
+				r.max_mem = ins.arg2long("--max-mem");
+				r.prt_reach_ts = Refs::OPT_PRT_REACH_TS;
+				r.prt_unreach_ts = Refs::OPT_PRT_UNREACH_TS;
+				r.prt_statistic = Refs::OPT_PRT_STATISTIC;
+				if (Client::query(socket, r))
+					return 0; /// the peak memory is the daemon's
+				cerr << "warning: no daemon on " << socket
+						<< ", running locally" << endl;
 			}
-			new_in.close();
+			model = Model::load(filename);
+		}
+		if (stats) {
+			stats->add_phase("parse", watch.elapsed());
+			stats->add_info("model", filename);
+			stats->add_info("mode",
+					is_cutoff ? "cutoff" :
+					targets != "X" ? "backward" :
+					is_modular ? "modular" :
+					is_incremental ? "incremental" : "standard");
 		}
 
 		if (ins.arg2bool("--adj-list") || Refs::OPT_PRT_ALL) {
 			cout << "Adjacency list:" << endl;
-			Util::print_adj_list(original_TTD);
+			model->to_stream();
+		}
+
+		if (targets != "X") {
+			vector<Thread_State> goals;
+			if (targets == "all") {
+				for (size_s s = 0; s < model->S(); ++s)
+					for (size_l l = 0; l < model->L(); ++l)
+						goals.emplace_back(s, l);
+			} else {
+				for (const auto& t : Util::split(targets, ','))
+					goals.emplace_back(Util::create_thread_state_from_str(t));
+			}
+			watch.restart();
+			BWS bws(*model);
+			ulong antichain = 0, predecessors = 0;
+			for (const auto& t : goals) {
+				const size_p k = bws.cover(init_ts, t);
+				cout << t << ": ";
+				if (k > 0)
+					cout << "coverable by " << k << " thread"
+							<< (k > 1 ? "s" : "") << " at " << init_ts << "\n";
+				else
+					cout << "not coverable from " << init_ts << "\n";
+				if (Refs::OPT_PRT_STATISTIC)
+					cout << "  " << bws.antichain_size()
+							<< " minimal elements (" << bws.generated()
+							<< " found), " << bws.predecessors()
+							<< " predecessors computed\n";
+				antichain = std::max(antichain, bws.antichain_size());
+				predecessors += bws.predecessors();
+			}
+			if (Refs::OPT_PRT_STATISTIC)
+				cout << "peak memory usage (KB): " << Memory::peak_rss() << endl;
+			if (stats) {
+				stats->add_phase("backward", watch.elapsed());
+				stats->add_info("antichain", std::to_string(antichain));
+				stats->add_info("predecessors", std::to_string(predecessors));
+				stats->to_json(stats_file);
+			}
+			return 0;
+		}
+
+		if (is_modular) {
+			watch.restart();
+			Thread_Modular modular(*model);
+			const auto over = modular.run(init_ts, n, s);
+			/// the states proven unreachable count as reached for the exact
+			/// search, which then stops once it has reached all the others
+			vector<vector<bool>> proven(model->S(),
+					vector<bool>(model->L(), false));
+			uint nproven = 0;
+			for (size_s s = 0; s < model->S(); ++s)
+				for (size_l l = 0; l < model->L(); ++l)
+					if (!over[s][l])
+						proven[s][l] = true, ++nproven;
+			const uint ncandidates = model->S() * model->L() - nproven;
+			cout << "thread-modular: " << nproven << " of "
+					<< model->S() * model->L()
+					<< " thread states unreachable, " << ncandidates
+					<< " undecided\n";
+			cout << "Unreachable Thread States:\n";
+			for (size_s s = 0; s < model->S(); ++s)
+				for (size_l l = 0; l < model->L(); ++l)
+					if (proven[s][l])
+						cout << s << "|" << l << "\n";
+			cout << endl;
+			bool stopped = false;
+			if (Refs::OPT_PRT_STATISTIC)
+				cout << "  " << modular.interferences()
+						<< " interference steps\n";
+			if (stats) {
+				stats->add_phase("modular", watch.elapsed());
+				stats->add_info("proven_unreachable", std::to_string(nproven));
+			}
+			if (is_confirm && ncandidates > 0) {
+				FWS fws(init_ts, *model);
+				fws.set_statistics(stats.get());
+				fws.set_memory_budget(max_mem);
+				fws.set_known_reachable(&proven);
+				fws.set_limits(timeout, max_states);
+				fws.set_interruptible(true);
+				const auto R = fws.explore(n, s);
+				stopped = !R.stopped.empty();
+				watch.restart();
+				for (const auto& note : R.notes)
+					cout << note << "\n";
+				uint nreachable = 0;
+				for (size_s s = 0; s < model->S(); ++s)
+					for (size_l l = 0; l < model->L(); ++l)
+						if (!proven[s][l] && R.reachable[s][l])
+							++nreachable;
+				cout << "confirmed: " << nreachable << " of " << ncandidates
+						<< " reachable, " << ncandidates - nreachable
+						<< (R.stopped.empty() ?
+								" unreachable\n" :
+								" unknown: the search stopped early ("
+										+ R.stopped + ")\n");
+				if (!R.is_exact())
+					cout << "the result is APPROXIMATE: bitstate storage may "
+							"have missed states, so some of these may be "
+							"reachable\n";
+				cout << (R.stopped.empty() ?
+						"Unreachable Thread States:\n" :
+						"Unknown Thread States:\n");
+				for (size_s s = 0; s < model->S(); ++s)
+					for (size_l l = 0; l < model->L(); ++l)
+						if (!proven[s][l] && !R.reachable[s][l])
+							cout << s << "|" << l << "\n";
+				cout << endl;
+				if (stats)
+					stats->add_phase("report", watch.elapsed());
+			}
+			if (Refs::OPT_PRT_STATISTIC)
+				cout << "peak memory usage (KB): " << Memory::peak_rss() << endl;
+			if (stats)
+				stats->to_json(stats_file);
+			return stopped ? 2 : 0;
+		}
+
+		if (is_incremental) {
+			ifstream in(edits_file.c_str());
+			if (!in.is_open())
+				throw CONTROL::Error("cannot open " + edits_file);
+			const auto edits = Incremental::read_edits(in);
+			in.close();
+			watch.restart();
+			Incremental inc(*model, edits);
+			Dump_Reader previous(previous_file);
+			const auto& h = previous.header();
+			unique_ptr<Dump_Writer> dump(
+					dump_file == "X" ?
+							nullptr :
+							new Dump_Writer(dump_file,
+									Dump_Header(model->S(), model->L(), h.init,
+											h.n, h.s)));
+			const auto R = inc.run(previous, dump.get());
+			if (stats)
+				stats->add_phase("incremental", watch.elapsed());
+			if (Refs::OPT_PRT_STATISTIC)
+				cout << "incremental: " << inc.saved() << " saved, "
+						<< inc.affected() << " affected, " << inc.seeds()
+						<< " seeds, " << inc.expanded() << " expanded\n";
+			FWS fws(h.init, inc.model());
+			fws.set_statistics(stats.get());
+			fws.report(R);
+			if (dump) {
+				dump->close(R.stopped.empty() && R.is_exact());
+				if (Refs::OPT_PRT_STATISTIC)
+					cout << "dumped " << dump->size() << " global states to "
+							<< dump_file << " (" << dump->bytes() << " bytes)"
+							<< endl;
+			}
+			if (Refs::OPT_PRT_STATISTIC)
+				cout << "peak memory usage (KB): " << Memory::peak_rss() << endl;
+			if (stats) {
+				stats->add_info("affected", std::to_string(inc.affected()));
+				stats->add_info("expanded", std::to_string(inc.expanded()));
+				stats->to_json(stats_file);
+			}
+			return 0;
 		}
 
-		FWS fws(init_ts, original_TTD);
+		if (batch_file != "X") {
+			ifstream in(batch_file.c_str());
+			if (!in.is_open())
+				throw CONTROL::Error("cannot open " + batch_file);
+			const auto queries = Batch::read_queries(in);
+			in.close();
+			Engine engine(model);
+			Batch batch(engine, max_mem);
+			batch.run(queries);
+			return 0;
+		}
+
+		watch.restart();
+		FWS fws(init_ts, *model);
+		fws.set_statistics(stats.get());
+		fws.set_memory_budget(max_mem);
+		const string repr = ins.arg_value("--repr");
+		fws.set_representation(
+				repr == "dense" ? FWS::DENSE :
+				repr == "sparse" ? FWS::SPARSE :
+				repr == "packed" ? FWS::PACKED :
+				repr == "symbolic" ? FWS::SYMBOLIC : FWS::AUTO);
+		fws.set_threads(ins.arg2long("--threads"));
+		fws.set_gallop_cutoff(ins.arg2bool("--gallop-cutoff"));
+		fws.set_limits(timeout, max_states);
+		fws.set_interruptible(true); /// a stopped search still reports
+		if (ins.arg2long("--procs") < 1)
+			throw CONTROL::Error("--procs must be positive");
+		fws.set_processes(ins.arg2long("--procs"));
+		const double interval = atof(ins.arg_value("--progress").c_str());
+		unique_ptr<Progress> progress(
+				interval > 0 ? new Progress(interval) : nullptr);
+		fws.set_progress(progress.get());
+		unique_ptr<Dump_Writer> dump(
+				dump_file == "X" ?
+						nullptr :
+						new Dump_Writer(dump_file,
+								Dump_Header(model->S(), model->L(), init_ts, n,
+										s)));
+		fws.set_dump(dump.get());
+		unique_ptr<Trace> trace(traces == "X" ? nullptr : new Trace(*model));
+		if (trace)
+			for (const auto& t : Util::split(traces, ','))
+				if (!model->contains(Util::create_thread_state_from_str(t)))
+					throw CONTROL::Error("trace target out of range: " + t);
+		fws.set_trace(trace.get());
+		if (progress)
+			progress->start();
+		if (stats)
+			stats->add_phase("preprocess", watch.elapsed());
+
+		Search_Result R;
 		if (is_cutoff)
 			fws.cutoff_detection();
 		else
-			fws.standard_FWS(n, s);
-		return 0;
+			R = fws.reachability_analysis(n, s);
+		if (progress)
+			progress->stop();
+		if (trace) {
+			for (const auto& t : Util::split(traces, ',')) {
+				const auto target = Util::create_thread_state_from_str(t);
+				if (trace->has_path(target))
+					trace->print_path(target);
+				else if (!R.stopped.empty())
+					cout << "No trace to " << t
+							<< ": unknown: the search stopped early ("
+							<< R.stopped << ")\n" << endl;
+				else if (trace->is_full())
+					cout << "No trace to " << t
+							<< ": unknown: the trace is full\n" << endl;
+				else if (!R.is_exact())
+					cout << "No trace to " << t
+							<< ": unknown: bitstate storage may have missed states\n"
+							<< endl;
+				else
+					cout << "No trace to " << t << ": unreachable\n" << endl;
+			}
+		}
+		if (dump) {
+			watch.restart();
+			dump->close(R.stopped.empty() && R.is_exact());
+			if (stats)
+				stats->add_phase("dump", watch.elapsed());
+			if (Refs::OPT_PRT_STATISTIC)
+				cout << "dumped " << dump->size() << " global states to "
+						<< dump_file << " (" << dump->bytes() << " bytes)"
+						<< endl;
+		}
+
+		if (Refs::OPT_PRT_STATISTIC) {
+			cout << "peak memory usage (KB): " << Memory::peak_rss() << endl;
+		}
+		if (stats)
+			stats->to_json(stats_file);
+		return fws.is_stopped() ? 2 : 0;
 	}
 
 	catch (const CONTROL::Error& error) {
@@ -0,0 +1,227 @@
+/*
+ * mdd.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "mdd.hh"
+
+namespace sura {
+
+const Node_ID MDD::EMPTY;
+const Node_ID MDD::FULL;
+
+/**
+ * @brief an empty forest
+ * @param domains: the domain of every level, from level 1 up
+ */
+MDD::MDD(const vector<uint>& domains) :
+		domains(1, 0), nodes(2, Node { 0, 0 }), free(domains.size() + 1), table(
+				1024, 0), union_cache(20), live(0), live_children(0), peak_live(0), threshold(
+				1 << 24), ncollections(0) {
+	this->domains.insert(this->domains.end(), domains.begin(), domains.end());
+	for (const auto& d : domains)
+		if (d == 0)
+			throw CONTROL::Error("MDD: empty domain");
+}
+
+/**
+ * @brief the node of level k with the given children, made unique
+ * @param k
+ * @param children: domain(k) nodes of level k - 1
+ * @return Node_ID: EMPTY if all children are
+ */
+Node_ID MDD::make(const uint& k, const vector<Node_ID>& children) {
+	bool empty = true;
+	for (const auto& c : children)
+		if (c != EMPTY) {
+			empty = false;
+			break;
+		}
+	if (empty)
+		return EMPTY;
+	const uint64_t mask = table.size() - 1;
+	uint64_t i = this->hash(k, children.data()) & mask;
+	for (; table[i] != 0; i = (i + 1) & mask) {
+		const Node& node = nodes[table[i]];
+		if (node.level == k
+				&& std::equal(children.begin(), children.end(),
+						arena.begin() + node.offset))
+			return table[i];
+	}
+
+	Node_ID p;
+	if (!free[k].empty()) {
+		p = free[k].back();
+		free[k].pop_back();
+		nodes[p].level = k;
+	} else {
+		p = nodes.size();
+		nodes.emplace_back(Node { k, uint(arena.size()) });
+		arena.resize(arena.size() + domains[k]);
+	}
+	std::copy(children.begin(), children.end(), arena.begin() + nodes[p].offset);
+	table[i] = p;
+	live_children += domains[k];
+	if (++live > peak_live)
+		peak_live = live;
+	if (10 * live > 7 * table.size())
+		this->grow_table();
+	return p;
+}
+
+/**
+ * @brief the union of two nodes of the same level
+ * @param a
+ * @param b
+ * @return Node_ID
+ */
+Node_ID MDD::unite(const Node_ID& a, const Node_ID& b) {
+	if (a == EMPTY || a == b)
+		return b;
+	if (b == EMPTY)
+		return a;
+	if (a == FULL || b == FULL)
+		return FULL;
+	const uint64_t key =
+			a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+	Node_ID r;
+	if (union_cache.find(key, r))
+		return r;
+	const uint k = nodes[a].level;
+	vector<Node_ID> children(domains[k]);
+	for (uint i = 0; i < domains[k]; ++i)
+		children[i] = this->unite(this->child(a, i), this->child(b, i));
+	r = this->make(k, children);
+	union_cache.store(key, r);
+	return r;
+}
+
+/**
+ * @brief the node of the single path x_k = values[k - 1]
+ * @param values: a value of every level, from level 1 up
+ * @return Node_ID
+ */
+Node_ID MDD::path(const vector<uint>& values) {
+	Node_ID p = FULL;
+	for (uint k = 1; k <= this->levels(); ++k) {
+		vector<Node_ID> children(domains[k], EMPTY);
+		children[values[k - 1]] = p;
+		p = this->make(k, children);
+	}
+	return p;
+}
+
+/**
+ * @brief the number of paths of root to FULL; as a long double, since
+ *        diagrams routinely encode more than 2^64 of them. Its mantissa has
+ *        64 bits, so the number is exact below 2^64 and rounded above
+ * @param root
+ * @return long double
+ */
+long double MDD::count(const Node_ID& root) {
+	std::unordered_map<Node_ID, long double> counts;
+	counts.emplace(EMPTY, 0);
+	counts.emplace(FULL, 1);
+	vector<std::pair<Node_ID, uint>> stack(1, std::make_pair(root, 0));
+	while (!stack.empty()) { /// post order, iterative: levels can be many
+		auto& top = stack.back();
+		const Node_ID p = top.first;
+		if (counts.count(p) > 0) {
+			stack.pop_back();
+			continue;
+		}
+		const uint k = nodes[p].level;
+		if (top.second < domains[k]) {
+			const Node_ID c = this->child(p, top.second++);
+			if (counts.count(c) == 0)
+				stack.emplace_back(c, 0);
+			continue;
+		}
+		long double sum = 0;
+		for (uint i = 0; i < domains[k]; ++i)
+			sum += counts[this->child(p, i)];
+		counts[p] = sum;
+		stack.pop_back();
+	}
+	return counts[root];
+}
+
+/**
+ * @brief free every node no protected node reaches, and drop the caches
+ */
+void MDD::collect() {
+	++ncollections;
+	vector<bool> marked(nodes.size(), false);
+	marked[EMPTY] = marked[FULL] = true;
+	vector<Node_ID> stack(protected_nodes);
+	for (const auto& buffer : protected_buffers)
+		stack.insert(stack.end(), buffer->begin(), buffer->end());
+	while (!stack.empty()) {
+		const Node_ID p = stack.back();
+		stack.pop_back();
+		if (marked[p])
+			continue;
+		marked[p] = true;
+		const uint k = nodes[p].level;
+		for (uint i = 0; i < domains[k]; ++i)
+			if (!marked[this->child(p, i)])
+				stack.emplace_back(this->child(p, i));
+	}
+
+	live = live_children = 0;
+	std::fill(table.begin(), table.end(), 0);
+	for (Node_ID p = 2; p < nodes.size(); ++p) {
+		if (nodes[p].level == UINT32_MAX)
+			continue;
+		if (marked[p]) {
+			++live;
+			live_children += domains[nodes[p].level];
+			this->insert_unique(p);
+		} else {
+			free[nodes[p].level].emplace_back(p);
+			nodes[p].level = UINT32_MAX;
+		}
+	}
+	union_cache.clear();
+	threshold = std::max(threshold, 2 * live_children);
+}
+
+/**
+ * @brief the bytes held by the forest
+ * @return ulong
+ */
+ulong MDD::bytes() const {
+	return nodes.capacity() * sizeof(Node)
+			+ arena.capacity() * sizeof(Node_ID)
+			+ table.size() * sizeof(Node_ID)
+			+ union_cache.bytes();
+}
+
+uint64_t MDD::hash(const uint& k, const Node_ID* children) const {
+	uint64_t h = 0x9e3779b97f4a7c15ULL ^ k;
+	for (uint i = 0; i < domains[k]; ++i) {
+		h ^= children[i];
+		h *= 0xbf58476d1ce4e5b9ULL;
+		h ^= h >> 29;
+	}
+	return h;
+}
+
+void MDD::insert_unique(const Node_ID& p) {
+	const uint64_t mask = table.size() - 1;
+	uint64_t i = this->hash(nodes[p].level, &arena[nodes[p].offset]) & mask;
+	while (table[i] != 0)
+		i = (i + 1) & mask;
+	table[i] = p;
+}
+
+void MDD::grow_table() {
+	vector<Node_ID>(2 * table.size(), 0).swap(table);
+	for (Node_ID p = 2; p < nodes.size(); ++p)
+		if (nodes[p].level != UINT32_MAX)
+			this->insert_unique(p);
+}
+
+} /* namespace sura */
@@ -0,0 +1,161 @@
+/*
+ * mdd.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef MDD_HH_
+#define MDD_HH_
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "algs.hh"
+
+namespace sura {
+
+typedef uint32_t Node_ID;
+
+/**
+ * @brief an operation cache: a direct-mapped table from nonzero keys to
+ *        nodes. A store overwrites the entry its key maps to, so the cache
+ *        forgets old results instead of growing, as in BDD packages.
+ */
+class Op_Cache {
+public:
+	explicit Op_Cache(const uint& bits) :
+			entries(size_t(1) << bits, Entry { 0, 0 }) {
+	}
+
+	inline bool find(const uint64_t& key, Node_ID& value) const {
+		const Entry& entry = entries[this->slot(key)];
+		if (entry.key != key)
+			return false;
+		value = entry.value;
+		return true;
+	}
+	inline void store(const uint64_t& key, const Node_ID& value) {
+		entries[this->slot(key)] = Entry { key, value };
+	}
+	inline void clear() {
+		std::fill(entries.begin(), entries.end(), Entry { 0, 0 });
+	}
+	inline ulong bytes() const {
+		return entries.size() * sizeof(Entry);
+	}
+
+private:
+	struct Entry {
+		uint64_t key; /// 0: empty
+		Node_ID value;
+	};
+	vector<Entry> entries;
+
+	inline size_t slot(const uint64_t& key) const {
+		return (key * 0x9e3779b97f4a7c15ULL >> 20) & (entries.size() - 1);
+	}
+};
+
+/**
+ * @brief a forest of quasi-reduced multi-valued decision diagrams over the
+ *        variables x_K, ..., x_1, x_k ranging over 0 .. domain(k) - 1. A
+ *        node at level k has one child per value of x_k, each a node at
+ *        level k - 1; level 0 holds the terminals EMPTY and FULL. A node
+ *        with only EMPTY children is EMPTY itself, and no two nodes are
+ *        equal: every node is made through the unique table.
+ *        Garbage collection is mark and sweep from the protected nodes: the
+ *        caller protects the nodes it holds, collects only when it holds no
+ *        other one, and drops its own caches then, as collect drops those
+ *        of the forest. Freed nodes are reused by later nodes of their
+ *        level.
+ */
+class MDD {
+public:
+	static const Node_ID EMPTY = 0;
+	static const Node_ID FULL = 1;
+
+	explicit MDD(const vector<uint>& domains);
+	~MDD() {
+	}
+
+	/// the number of variables
+	inline uint levels() const {
+		return domains.size() - 1;
+	}
+	inline uint domain(const uint& k) const {
+		return domains[k];
+	}
+	inline uint level(const Node_ID& p) const {
+		return nodes[p].level;
+	}
+	inline Node_ID child(const Node_ID& p, const uint& i) const {
+		return arena[nodes[p].offset + i];
+	}
+
+	Node_ID make(const uint& k, const vector<Node_ID>& children);
+	Node_ID unite(const Node_ID& a, const Node_ID& b);
+	Node_ID path(const vector<uint>& values);
+	long double count(const Node_ID& root);
+
+	/// protect the nodes of a buffer, or one node, until unprotected
+	inline void protect(const vector<Node_ID>* buffer) {
+		protected_buffers.emplace_back(buffer);
+	}
+	inline void unprotect_buffer() {
+		protected_buffers.pop_back();
+	}
+	inline void protect(const Node_ID& p) {
+		protected_nodes.emplace_back(p);
+	}
+	inline void unprotect_node() {
+		protected_nodes.pop_back();
+	}
+
+	/// have the children of the nodes grown enough since the last
+	/// collection?
+	inline bool needs_collection() const {
+		return live_children >= threshold;
+	}
+	void collect();
+
+	inline ulong size() const {
+		return live;
+	}
+	inline ulong peak() const {
+		return peak_live;
+	}
+	inline ulong collections() const {
+		return ncollections;
+	}
+	ulong bytes() const;
+
+private:
+	struct Node {
+		uint level;  /// UINT32_MAX: freed
+		uint offset; /// of the children in arena
+	};
+
+	vector<uint> domains;         /// by level, 0 unused
+	vector<Node> nodes;
+	vector<Node_ID> arena;        /// the children of all nodes
+	vector<vector<Node_ID>> free; /// by level: freed nodes
+	vector<Node_ID> table;        /// unique table, 0 is empty
+	Op_Cache union_cache;
+	ulong live;
+	ulong live_children;
+	ulong peak_live;
+	ulong threshold; /// of live_children
+	ulong ncollections;
+
+	vector<const vector<Node_ID>*> protected_buffers;
+	vector<Node_ID> protected_nodes;
+
+	uint64_t hash(const uint& k, const Node_ID* children) const;
+	void insert_unique(const Node_ID& p);
+	void grow_table();
+};
+
+} /* namespace sura */
+
+#endif /* MDD_HH_ */
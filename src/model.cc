@@ -0,0 +1,165 @@
+/*
+ * model.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "model.hh"
+
+namespace sura {
+
+/**
+ * @brief compile a thread transition system
+ * @param S        : the size of shared states
+ * @param L        : the size of local  states
+ * @param TTD      : all transitions, including the spawn transitions
+ * @param spawn_TTD: the spawn transitions
+ */
+Model::Model(const size_s& S, const size_l& L, const adjacency_list& TTD,
+		const adjacency_list& spawn_TTD) :
+		nshared(S), nlocal(L), nedges(0), nspawns(0), out(S * L) {
+	for (const auto& p : TTD) {
+		if (!this->contains(p.first))
+			throw CONTROL::Error("thread state out of range");
+		auto ispawn = spawn_TTD.find(p.first);
+		for (const auto& dst : p.second) {
+			if (!this->contains(dst))
+				throw CONTROL::Error("thread state out of range");
+			const bool is_spawn = ispawn != spawn_TTD.end()
+					&& std::find(ispawn->second.begin(), ispawn->second.end(),
+							dst) != ispawn->second.end();
+			out[index(p.first)].emplace_back(dst, is_spawn);
+			++nedges;
+			if (is_spawn)
+				++nspawns;
+		}
+	}
+	first.reserve(out.size());
+	uint id = 0;
+	for (const auto& edges : out) {
+		first.emplace_back(id);
+		id += edges.size();
+	}
+}
+
+/**
+ * @brief read and compile a thread transition system from file
+ * @param filename
+ * @return the compiled model
+ */
+shared_ptr<const Model> Model::load(const string& filename) {
+	ifstream in(filename.c_str());
+	if (!in.is_open())
+		throw CONTROL::Error("cannot open " + filename);
+	return load(in);
+}
+
+/**
+ * @brief read and compile a thread transition system. The format is
+ *          S L
+ *          s1 l1 -> s2 l2   (a normal transition)
+ *          s1 l1 +> s2 l2   (a spawn  transition)
+ *          ...
+ *        where "#" starts a comment
+ * @param in
+ * @return the compiled model
+ */
+shared_ptr<const Model> Model::load(istream& in) {
+	std::stringstream no_comment;
+	CONTROL::remove_comments(in, no_comment, "#");
+
+	size_s S = 0;
+	size_l L = 0;
+	if (!(no_comment >> S >> L))
+		throw CONTROL::Error("missing the sizes of shared and local states");
+	adjacency_list TTD, spawn_TTD;
+	ushort s1, l1, s2, l2;
+	string sep;
+	while (no_comment >> s1 >> l1 >> sep >> s2 >> l2) {
+		if (sep == "->" || sep == "+>") {
+			if (sep == "+>")
+				spawn_TTD[Thread_State(s1, l1)].emplace_back(s2, l2);
+			TTD[Thread_State(s1, l1)].emplace_back(s2, l2);
+		} else {
+			throw CONTROL::Error("illegal transition");
+		}
+	}
+	return std::make_shared<const Model>(S, L, TTD, spawn_TTD);
+}
+
+/**
+ * @brief the thread state a transition leaves, see edge_id
+ * @param id
+ * @return Thread_State
+ */
+Thread_State Model::edge_source(const uint& id) const {
+	if (id >= nedges)
+		throw CONTROL::Error("transition out of range");
+	const uint i = std::upper_bound(first.begin(), first.end(), id)
+			- first.begin() - 1;
+	return Thread_State(i / nlocal, i % nlocal);
+}
+
+/**
+ * @brief the transition of an id, see edge_id
+ * @param id
+ * @return Edge
+ */
+const Edge& Model::edge(const uint& id) const {
+	const auto t = this->edge_source(id);
+	return out[index(t)][id - first[index(t)]];
+}
+
+/**
+ * @brief the bytes used by the compiled transitions
+ * @return ulong
+ */
+ulong Model::bytes() const {
+	return out.size() * (sizeof(vector<Edge>) + sizeof(uint))
+			+ nedges * sizeof(Edge);
+}
+
+/**
+ * @brief all transitions as an adjacency list
+ * @return adjacency_list
+ */
+adjacency_list Model::adjacency() const {
+	adjacency_list TTD;
+	for (size_s s = 0; s < nshared; ++s)
+		for (size_l l = 0; l < nlocal; ++l)
+			for (const auto& e : out[s * nlocal + l])
+				TTD[Thread_State(s, l)].emplace_back(e.dst);
+	return TTD;
+}
+
+/**
+ * @brief the spawn transitions as an adjacency list
+ * @return adjacency_list
+ */
+adjacency_list Model::spawn_adjacency() const {
+	adjacency_list spawn_TTD;
+	for (size_s s = 0; s < nshared; ++s)
+		for (size_l l = 0; l < nlocal; ++l)
+			for (const auto& e : out[s * nlocal + l])
+				if (e.is_spawn)
+					spawn_TTD[Thread_State(s, l)].emplace_back(e.dst);
+	return spawn_TTD;
+}
+
+/**
+ * @brief print the model in the input format
+ * @param out
+ * @return ostream
+ */
+ostream& Model::to_stream(ostream& out) const {
+	out << nshared << " " << nlocal << endl;
+	for (size_s s = 0; s < nshared; ++s)
+		for (size_l l = 0; l < nlocal; ++l)
+			for (const auto& e : this->out[s * nlocal + l])
+				out << Thread_State(s, l) << (e.is_spawn ? " +> " : " -> ")
+						<< e.dst << endl;
+	return out;
+}
+
+} /* namespace sura */
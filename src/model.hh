@@ -0,0 +1,95 @@
+/*
+ * model.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef MODEL_HH_
+#define MODEL_HH_
+
+#include "state.hh"
+
+namespace sura {
+
+/// a transition of a compiled model: its destination, and whether it is a
+/// spawn transition
+struct Edge {
+	Thread_State dst;
+	bool is_spawn;
+
+	Edge(const Thread_State& dst, const bool& is_spawn) :
+			dst(dst), is_spawn(is_spawn) {
+	}
+};
+
+/**
+ * @brief a compiled thread transition system. The outgoing transitions of
+ *        every thread state are stored in one vector indexed by the thread
+ *        state, each transition flagged as spawn or not, so the search never
+ *        looks up a map. A model is immutable once built and owns all of its
+ *        data: it uses neither Thread_State::S/L nor Refs::spawntra_TTD, and
+ *        can be shared by any number of concurrent searches.
+ */
+class Model {
+public:
+	Model(const size_s& S, const size_l& L, const adjacency_list& TTD,
+			const adjacency_list& spawn_TTD);
+	~Model() {
+	}
+
+	static shared_ptr<const Model> load(const string& filename);
+	static shared_ptr<const Model> load(istream& in);
+
+	inline size_s S() const {
+		return nshared;
+	}
+	inline size_l L() const {
+		return nlocal;
+	}
+
+	/// the index of a thread state in S x L
+	inline uint index(const Thread_State& t) const {
+		return t.share * nlocal + t.local;
+	}
+	inline bool contains(const Thread_State& t) const {
+		return t.share < nshared && t.local < nlocal;
+	}
+
+	/// the outgoing transitions of thread state t
+	inline const vector<Edge>& successors(const Thread_State& t) const {
+		return out[index(t)];
+	}
+
+	/// the number of transition e, an element of successors(t), among all
+	/// transitions of the model
+	inline uint edge_id(const Thread_State& t, const Edge& e) const {
+		return first[index(t)] + (&e - out[index(t)].data());
+	}
+	Thread_State edge_source(const uint& id) const;
+	const Edge& edge(const uint& id) const;
+
+	inline ulong size() const {
+		return nedges;
+	}
+	inline bool has_spawns() const {
+		return nspawns > 0;
+	}
+	ulong bytes() const;
+
+	adjacency_list adjacency() const;
+	adjacency_list spawn_adjacency() const;
+	ostream& to_stream(ostream& out = cout) const;
+
+private:
+	size_s nshared;
+	size_l nlocal;
+	ulong nedges;
+	ulong nspawns;
+	vector<vector<Edge>> out; /// indexed by Model::index
+	vector<uint> first;       /// the id of the first transition of out[i]
+};
+
+} /* namespace sura */
+
+#endif /* MODEL_HH_ */
@@ -0,0 +1,86 @@
+/*
+ * modular.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "modular.hh"
+
+namespace sura {
+
+Thread_Modular::Thread_Modular(const Model& model) :
+		model(model), ninterferences(0) {
+}
+
+/**
+ * @brief the over-approximation for n threads at init and at most s spawn
+ *        transitions. Interference needs a second thread, so it is off if
+ *        n + s < 2; spawn transitions are off if s = 0.
+ * @param init
+ * @param n
+ * @param s
+ * @return S x L: false for the thread states that are unreachable
+ */
+vector<vector<bool>> Thread_Modular::run(const Thread_State& init,
+		const size_p& n, const size_p& s) {
+	if (!model.contains(init))
+		throw CONTROL::Error("thread state out of range");
+	marked.assign(model.S(), vector<bool>(model.L(), false));
+	present.assign(model.S(), vector<Local_State>());
+	moves.assign(model.S(), vector<Shared_State>());
+	is_move.assign(model.S(), vector<bool>(model.S(), false));
+	worklist.clear();
+	ninterferences = 0;
+	const bool interfere = ulong(n) + s >= 2;
+
+	this->mark(init);
+	while (!worklist.empty()) {
+		const Thread_State t = worklist.back();
+		worklist.pop_back();
+		/// t moves, and moves the others
+		for (const auto& e : model.successors(t)) {
+			if (e.is_spawn && s == 0)
+				continue;
+			this->mark(e.dst);
+			if (e.is_spawn) /// the spawner stays at its local state
+				this->mark(Thread_State(e.dst.share, t.local));
+			if (e.dst.share != t.share)
+				this->add_move(t.share, e.dst.share, interfere);
+		}
+		/// t is moved by the others
+		if (interfere)
+			for (const auto& to : moves[t.share])
+				this->mark(Thread_State(to, t.local)), ++ninterferences;
+	}
+	return marked;
+}
+
+void Thread_Modular::mark(const Thread_State& t) {
+	if (marked[t.share][t.local])
+		return;
+	marked[t.share][t.local] = true;
+	present[t.share].emplace_back(t.local);
+	worklist.emplace_back(t);
+}
+
+/**
+ * @brief a marked thread changes the shared state from from to to: every
+ *        thread marked at from, now or later, may see it
+ * @param from
+ * @param to
+ * @param interfere
+ */
+void Thread_Modular::add_move(const Shared_State& from, const Shared_State& to,
+		const bool& interfere) {
+	if (is_move[from][to])
+		return;
+	is_move[from][to] = true;
+	moves[from].emplace_back(to);
+	if (!interfere)
+		return;
+	for (const auto& m : present[from])
+		this->mark(Thread_State(to, m)), ++ninterferences;
+}
+
+} /* namespace sura */
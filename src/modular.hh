@@ -0,0 +1,59 @@
+/*
+ * modular.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef MODULAR_HH_
+#define MODULAR_HH_
+
+#include "model.hh"
+
+namespace sura {
+
+/**
+ * @brief a thread-modular over-approximation of the reachable thread
+ *        states. It tracks, per shared state, the locals a thread may be in,
+ *        not the counters: a thread moves by its own transitions, and, by
+ *        interference, a thread at (s, m) sees every shared state change
+ *        (s, l) -> (s', l') of another thread and moves to (s', m). Any two
+ *        marked thread states of the same shared state are assumed to
+ *        coexist, as soon as there can be two threads. Every reachable
+ *        thread state is marked, so an unmarked one is unreachable; a marked
+ *        one may be unreachable too. The fixpoint marks every thread state
+ *        at most once, and takes O(S * L * (S + degree)) time: the
+ *        interference of a thread state walks the moves of its shared state,
+ *        up to S of them.
+ */
+class Thread_Modular {
+public:
+	explicit Thread_Modular(const Model& model);
+	~Thread_Modular() {
+	}
+
+	vector<vector<bool>> run(const Thread_State& init, const size_p& n,
+			const size_p& s);
+
+	/// the interference steps of the last run
+	inline ulong interferences() const {
+		return ninterferences;
+	}
+
+private:
+	const Model& model;
+	vector<vector<bool>> marked;
+	vector<vector<Local_State>> present; /// by shared state: marked locals
+	vector<vector<Shared_State>> moves;  /// by shared state: the shared
+	vector<vector<bool>> is_move;        /// states a marked thread moves to
+	vector<Thread_State> worklist;
+	ulong ninterferences;
+
+	void mark(const Thread_State& t);
+	void add_move(const Shared_State& from, const Shared_State& to,
+			const bool& interfere);
+};
+
+} /* namespace sura */
+
+#endif /* MODULAR_HH_ */
@@ -0,0 +1,268 @@
+/*
+ * packed.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef PACKED_HH_
+#define PACKED_HH_
+
+#include <cstdint>
+
+#include "state.hh"
+
+namespace sura {
+
+/**
+ * @brief a global state packed into K 64-bit words: the counter of every
+ *        local state, and the shared state, each in a bit field as narrow as
+ *        its bound allows, see Packing. States compare as unsigned integers,
+ *        word 0 most significant.
+ */
+template<size_t K>
+struct Packed_State {
+	uint64_t w[K];
+
+	Packed_State() {
+		for (size_t i = 0; i < K; ++i)
+			w[i] = 0;
+	}
+
+	inline bool operator<(const Packed_State& other) const {
+		for (size_t i = 0; i < K; ++i)
+			if (w[i] != other.w[i])
+				return w[i] < other.w[i];
+		return false;
+	}
+	inline bool operator==(const Packed_State& other) const {
+		for (size_t i = 0; i < K; ++i)
+			if (w[i] != other.w[i])
+				return false;
+		return true;
+	}
+	inline bool operator!=(const Packed_State& other) const {
+		return !(*this == other);
+	}
+};
+
+/**
+ * @brief the layout of packed states: a counter field of bits(bound) bits
+ *        per local state, then a shared field of bits(S - 1) bits. Fields
+ *        are laid out in order and never straddle two words, so a transition
+ *        changes a packed state by a few word operations, without unpacking.
+ */
+class Packing {
+public:
+	/// the widest packed states
+	static const size_t MAX_WORDS = 4;
+
+	Packing(const size_s& S, const size_l& L, culong& bound) :
+			L(L), counter_bits(bits(bound)), nwords(1), word(L + 1), shift(
+					L + 1) {
+		uint used = 0;
+		for (size_l l = 0; l <= L; ++l) {
+			const uint b = l < L ? counter_bits : bits(S > 0 ? S - 1 : 0);
+			if (used + b > 64)
+				++nwords, used = 0;
+			word[l] = nwords - 1;
+			shift[l] = used;
+			used += b;
+		}
+		share_mask = (~0ULL >> (64 - bits(S > 0 ? S - 1 : 0))) << shift[L];
+	}
+
+	/// the number of words of a packed state, or 0 if more than MAX_WORDS
+	inline size_t words() const {
+		return nwords <= MAX_WORDS ? nwords : 0;
+	}
+
+	template<size_t K>
+	inline size_p get(const Packed_State<K>& g, const Local_State& l) const {
+		return (g.w[word[l]] >> shift[l]) & (~0ULL >> (64 - counter_bits));
+	}
+	template<size_t K>
+	inline void inc(Packed_State<K>& g, const Local_State& l) const {
+		g.w[word[l]] += 1ULL << shift[l];
+	}
+	template<size_t K>
+	inline void dec(Packed_State<K>& g, const Local_State& l) const {
+		g.w[word[l]] -= 1ULL << shift[l];
+	}
+	template<size_t K>
+	inline Shared_State share(const Packed_State<K>& g) const {
+		return (g.w[word[L]] & share_mask) >> shift[L];
+	}
+	template<size_t K>
+	inline void set_share(Packed_State<K>& g, const Shared_State& s) const {
+		g.w[word[L]] = (g.w[word[L]] & ~share_mask)
+				| (uint64_t(s) << shift[L]);
+	}
+
+	/// n threads at t
+	template<size_t K>
+	Packed_State<K> pack(const Thread_State& t, const size_p& n) const {
+		Packed_State<K> g;
+		g.w[word[t.local]] = uint64_t(n) << shift[t.local];
+		this->set_share(g, t.share);
+		return g;
+	}
+
+	/// the counters of g must not exceed the bound
+	template<size_t K>
+	Packed_State<K> pack(const Global_State& g) const {
+		Packed_State<K> _g;
+		for (const auto& p : g.locals)
+			_g.w[word[p.first]] |= uint64_t(p.second) << shift[p.first];
+		this->set_share(_g, g.share);
+		return _g;
+	}
+
+	template<size_t K>
+	Global_State unpack(const Packed_State<K>& g) const {
+		Global_State u;
+		u.share = this->share(g);
+		for (size_l l = 0; l < L; ++l) {
+			const auto c = this->get(g, l);
+			if (c > 0)
+				u.locals.emplace_hint(u.locals.end(), l, c);
+		}
+		return u;
+	}
+
+	/// the bits of x, at least 1
+	static inline uint bits(culong& x) {
+		uint b = 1;
+		while (b < 64 && (x >> b) != 0)
+			++b;
+		return b;
+	}
+
+private:
+	size_l L;
+	uint counter_bits;
+	size_t nwords;
+	vector<uint> word;  /// by local state, L for the shared state
+	vector<uint> shift; /// by local state, L for the shared state
+	uint64_t share_mask;
+};
+
+/**
+ * @brief the hash of a packed state
+ * @param g
+ * @return uint64_t
+ */
+template<size_t K>
+inline uint64_t hash(const Packed_State<K>& g) {
+	uint64_t h = 0x9e3779b97f4a7c15ULL;
+	for (size_t i = 0; i < K; ++i) {
+		h ^= g.w[i];
+		h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+		h ^= h >> 31;
+	}
+	return h;
+}
+
+/**
+ * @brief a set of packed states that also is a worklist, as Dense_Set: the
+ *        states in the order of insertion, and an open-addressing table of
+ *        their indices
+ */
+template<size_t K>
+class Packed_Set {
+public:
+	static const size_t NONE = SIZE_MAX;
+
+	Packed_Set() :
+			table(1024, 0) {
+	}
+
+	/// insert g, given h = hash(g); false if it was inserted before
+	bool insert(const Packed_State<K>& g, const uint64_t& h) {
+		if (10 * (states.size() + 1) > 7 * table.size())
+			this->grow_table();
+		const uint64_t mask = table.size() - 1;
+		for (uint64_t i = h & mask;; i = (i + 1) & mask) {
+			if (table[i] == 0) {
+				states.emplace_back(g);
+				table[i] = states.size();
+				return true;
+			}
+			if (states[table[i] - 1] == g)
+				return false;
+		}
+	}
+
+	/// the index of g, given h = hash(g), or NONE
+	size_t find(const Packed_State<K>& g, const uint64_t& h) const {
+		const uint64_t mask = table.size() - 1;
+		for (uint64_t i = h & mask; table[i] != 0; i = (i + 1) & mask)
+			if (states[table[i] - 1] == g)
+				return table[i] - 1;
+		return NONE;
+	}
+
+	inline const Packed_State<K>& operator[](const size_t& i) const {
+		return states[i];
+	}
+	inline size_t size() const {
+		return states.size();
+	}
+	inline ulong bytes() const {
+		return states.capacity() * sizeof(Packed_State<K> )
+				+ table.size() * sizeof(uint64_t);
+	}
+
+private:
+	vector<Packed_State<K>> states;
+	vector<uint64_t> table; /// index + 1 into states, 0 is empty
+
+	void grow_table() {
+		vector<uint64_t>(2 * table.size(), 0).swap(table);
+		const uint64_t mask = table.size() - 1;
+		for (size_t k = 0; k < states.size(); ++k) {
+			auto i = hash(states[k]) & mask;
+			while (table[i] != 0)
+				i = (i + 1) & mask;
+			table[i] = k + 1;
+		}
+	}
+};
+
+/**
+ * @brief sort packed states by an LSD radix sort over their bytes. Bytes
+ *        equal in all states are skipped, so narrow states take few passes
+ * @param a  : the states
+ * @param tmp: a buffer, reused across calls
+ */
+template<size_t K>
+void radix_sort(vector<Packed_State<K>>& a, vector<Packed_State<K>>& tmp) {
+	if (a.size() < 2)
+		return;
+	uint64_t ors[K], ands[K];
+	for (size_t i = 0; i < K; ++i)
+		ors[i] = 0, ands[i] = ~0ULL;
+	for (const auto& g : a)
+		for (size_t i = 0; i < K; ++i)
+			ors[i] |= g.w[i], ands[i] &= g.w[i];
+	tmp.resize(a.size());
+	for (size_t i = K; i-- > 0;) {
+		for (uint shift = 0; shift < 64; shift += 8) {
+			if ((((ors[i] ^ ands[i]) >> shift) & 0xff) == 0)
+				continue;
+			size_t count[257] = { 0 };
+			for (const auto& g : a)
+				++count[((g.w[i] >> shift) & 0xff) + 1];
+			for (uint b = 0; b < 256; ++b)
+				count[b + 1] += count[b];
+			for (const auto& g : a)
+				tmp[count[(g.w[i] >> shift) & 0xff]++] = g;
+			a.swap(tmp);
+		}
+	}
+}
+
+} /* namespace sura */
+
+#endif /* PACKED_HH_ */
@@ -0,0 +1,101 @@
+/*
+ * progress.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include <iomanip>
+
+#include "progress.hh"
+#include "algs.hh"
+
+namespace sura {
+
+Progress::Progress(const double& interval, ostream& out) :
+		states(0), frontier(0), depth(0), reached_ts(0), interval(interval), out(
+				out), n(0), s(0), epoch(0), stopped(true) {
+}
+
+Progress::~Progress() {
+	this->stop();
+}
+
+/**
+ * @brief reset the counters for a new search with n threads and s spawns
+ * @param n
+ * @param s
+ */
+void Progress::begin_search(culong& n, culong& s) {
+	this->n.store(n, std::memory_order_relaxed);
+	this->s.store(s, std::memory_order_relaxed);
+	states.store(0, std::memory_order_relaxed);
+	frontier.store(1, std::memory_order_relaxed);
+	depth.store(0, std::memory_order_relaxed);
+	reached_ts.store(0, std::memory_order_relaxed);
+	epoch.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief start the sampling thread
+ */
+void Progress::start() {
+	std::lock_guard<std::mutex> lock(mtx);
+	if (!stopped)
+		return;
+	stopped = false;
+	watch.restart();
+	sampler = std::thread(&Progress::sample, this);
+}
+
+/**
+ * @brief stop the sampling thread and wait for it
+ */
+void Progress::stop() {
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		if (stopped)
+			return;
+		stopped = true;
+	}
+	cv.notify_all();
+	sampler.join();
+}
+
+/**
+ * @brief the body of the sampling thread: print one line every interval
+ */
+void Progress::sample() {
+	ulong last_states = 0, last_ts = 0, last_epoch = 0;
+	double last_time = 0;
+	const auto flags = out.flags();
+	const auto precision = out.precision();
+	std::unique_lock<std::mutex> lock(mtx);
+	while (!cv.wait_for(lock,
+			std::chrono::duration<double>(interval), [this] {return stopped;})) {
+		const double now = watch.elapsed();
+		const ulong e = epoch.load(std::memory_order_acquire);
+		const ulong nstates = states.load(std::memory_order_relaxed);
+		const ulong nts = reached_ts.load(std::memory_order_relaxed);
+		/// a new search started since the last line; the counters may
+		/// already be reset while the epoch is not yet bumped
+		if (e != last_epoch || nstates < last_states || nts < last_ts)
+			last_states = 0, last_ts = 0, last_epoch = e;
+
+		out << "[progress] " << std::fixed << std::setprecision(1) << now
+				<< "s  n=" << n.load(std::memory_order_relaxed) << " s="
+				<< s.load(std::memory_order_relaxed) << "  states " << nstates
+				<< " (" << std::setprecision(0)
+				<< (nstates - last_states) / (now - last_time) << "/s)"
+				<< "  frontier " << frontier.load(std::memory_order_relaxed)
+				<< "  depth " << depth.load(std::memory_order_relaxed)
+				<< "  thread states " << nts << " (+" << (nts - last_ts)
+				<< ")  rss " << Memory::current_rss() / 1024 << " MB" << endl;
+		out.flags(flags);
+		out.precision(precision);
+
+		last_states = nstates, last_ts = nts, last_time = now;
+	}
+}
+
+} /* namespace sura */
@@ -0,0 +1,62 @@
+/*
+ * progress.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef PROGRESS_HH_
+#define PROGRESS_HH_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "heads.hh"
+#include "stats.hh"
+
+namespace sura {
+
+/**
+ * @brief live progress of long searches. The search publishes its counters
+ *        into the atomics below every few thousand expansions, with relaxed
+ *        stores only; a sampling thread reads them periodically and prints
+ *        a progress line. The search itself never waits for the sampler.
+ */
+class Progress {
+public:
+	/// how many expansions the search does between two publications
+	static const ulong PUBLISH_PERIOD = 4096;
+
+	std::atomic<ulong> states;     /// reachable global states
+	std::atomic<ulong> frontier;   /// size of the worklist
+	std::atomic<ulong> depth;      /// current BFS depth
+	std::atomic<ulong> reached_ts; /// reached thread states
+
+	Progress(const double& interval, ostream& out = cerr);
+	~Progress();
+
+	void begin_search(culong& n, culong& s);
+	void start();
+	void stop();
+
+private:
+	const double interval; /// seconds between two progress lines
+	ostream& out;
+
+	std::atomic<ulong> n, s; /// the setting of the current search
+	std::atomic<ulong> epoch; /// bumped by every begin_search
+	Stopwatch watch;
+
+	std::thread sampler;
+	std::mutex mtx;
+	std::condition_variable cv;
+	bool stopped;
+
+	void sample();
+};
+
+} /* namespace sura */
+
+#endif /* PROGRESS_HH_ */
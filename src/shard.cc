@@ -0,0 +1,397 @@
+/*
+ * shard.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "shard.hh"
+#include "fws.hh"
+
+#include <csignal>
+#include <cstring>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace sura {
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+		"sharded search needs lock-free 64-bit atomics");
+
+/////////////////////// shared memory ////////////////////////////////
+
+/**
+ * @brief map the shared memory of P workers. The rings are not touched here:
+ *        every worker initializes its incoming ones
+ * @param P
+ * @param thread_states: S * L
+ */
+template<size_t K>
+Shared_Region<K>::Shared_Region(const uint& P, const size_t& thread_states) :
+		P(P), thread_states(thread_states) {
+	rings = 4096;
+	results = rings + ulong(P) * P * sizeof(Ring<K> );
+	marks = results + P * sizeof(Shard_Result);
+	size = marks + P * thread_states;
+	void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED)
+		throw CONTROL::Error("cannot map shared memory for the shards");
+	base = static_cast<char*>(p);
+	new (&this->work()) std::atomic<uint64_t>(P);
+	new (&this->ready()) std::atomic<uint64_t>(0);
+}
+
+template<size_t K>
+Shared_Region<K>::~Shared_Region() {
+	::munmap(base, size);
+}
+
+/////////////////////// workers ////////////////////////////////
+
+namespace {
+
+/**
+ * @brief one worker process of a sharded search. It owns the states whose
+ *        hash maps to it: it stores and expands them, and sends every
+ *        successor owned by another worker to that worker, in batches.
+ *        Termination: the shared counter work is the number of active
+ *        workers plus the number of states sent but not yet received. A
+ *        sender counts a batch before publishing it, a receiver uncounts it
+ *        after storing its states, and an idle worker counts itself active
+ *        before it receives; so work drops to 0 only when every worker is
+ *        idle and no state is in transit, and then the search is over.
+ */
+template<size_t K>
+class Shard_Worker {
+public:
+	/// states per batch
+	static const size_t BATCH = 256;
+	/// expansions between two polls of the incoming rings
+	static const ulong POLL = 64;
+
+	Shard_Worker(const Model& model, const Packing& packing,
+			Shared_Region<K>& region, const uint& P, const uint& w,
+			culong& bound) :
+			model(model), packing(packing), region(region), P(P), w(w), bound(
+					bound), out(P), result( { 0, 0, 0, 0, 0, 0, 0 }) {
+	}
+
+	void run(const Packed_State<K>& init);
+
+private:
+	const Model& model;
+	const Packing& packing;
+	Shared_Region<K>& region;
+	const uint P;
+	const uint w;
+	const ulong bound;
+
+	Packed_Set<K> R; /// the reached states of the shard, and the worklist
+	vector<vector<Packed_State<K>>> out; /// batches to other workers
+	vector<Packed_State<K>> in;
+	Shard_Result result;
+
+	inline uint owner(const uint64_t& h) const {
+		return (h >> 32) % P;
+	}
+
+	void expand(const Packed_State<K>& tau);
+	void add(const Packed_State<K>& g);
+	void flush(const uint& to);
+	void receive();
+	bool has_incoming();
+	void finish();
+};
+
+/**
+ * @brief pin the worker to a CPU, initialize its incoming rings, and
+ *        explore its shard until the whole search terminates
+ * @param init
+ */
+template<size_t K>
+void Shard_Worker<K>::run(const Packed_State<K>& init) {
+	/// only the CPUs of the inherited mask, e.g. under taskset or a cpuset
+	cpu_set_t allowed;
+	if (::sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+		const int ncpus = CPU_COUNT(&allowed);
+		int cpu = -1;
+		for (int k = w % ncpus; k >= 0; --k)
+			while (!CPU_ISSET(++cpu, &allowed))
+				;
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		CPU_SET(cpu, &cpus);
+		::sched_setaffinity(0, sizeof(cpus), &cpus); /// best effort
+	}
+	/// first touch: the incoming rings are placed where they are read
+	for (uint from = 0; from < P; ++from) {
+		auto& ring = region.ring(from, w);
+		std::memset(static_cast<void*>(ring.slots), 0, sizeof(ring.slots));
+		new (&ring.head) std::atomic<uint64_t>(0);
+		new (&ring.tail) std::atomic<uint64_t>(0);
+	}
+	region.ready().fetch_add(1);
+	while (region.ready().load() < P)
+		::sched_yield();
+
+	const uint64_t h = hash(init);
+	if (this->owner(h) == w)
+		R.insert(init, h);
+	size_t next = 0;
+	ulong polls = 0;
+	while (true) {
+		if (next < R.size()) {
+			if (++polls % POLL == 0)
+				this->receive();
+			const Packed_State<K> tau = R[next++];
+			this->expand(tau);
+			continue;
+		}
+		for (uint to = 0; to < P; ++to)
+			if (!out[to].empty())
+				this->flush(to);
+		this->receive();
+		if (next < R.size())
+			continue;
+		region.work().fetch_sub(1); /// idle
+		while (region.work().load() > 0 && !this->has_incoming())
+			::sched_yield();
+		if (!this->has_incoming())
+			break; /// work is 0: every worker is idle, no state in transit
+		region.work().fetch_add(1); /// active again
+		this->receive();
+	}
+	this->finish();
+}
+
+/**
+ * @brief fire all transitions of tau
+ * @param tau: a copy, as receiving may move the states of R
+ */
+template<size_t K>
+void Shard_Worker<K>::expand(const Packed_State<K>& tau) {
+	result.expanded++;
+	const Shared_State share = packing.share(tau);
+	ulong threads = 0;
+	for (Local_State l = 0; l < model.L(); ++l)
+		threads += packing.get(tau, l);
+	const ulong budget = bound - threads;
+	for (Local_State l = 0; l < model.L(); ++l) {
+		if (packing.get(tau, l) == 0)
+			continue;
+		for (const auto& e : model.successors(Thread_State(share, l))) {
+			if (e.is_spawn) {
+				if (budget == 0)
+					continue;
+				result.spawns++;
+			}
+			result.edges++;
+			Packed_State<K> _tau(tau);
+			if (!e.is_spawn)
+				packing.dec(_tau, l);
+			packing.inc(_tau, e.dst.local);
+			packing.set_share(_tau, e.dst.share);
+			this->add(_tau);
+		}
+	}
+}
+
+/**
+ * @brief store a successor of the shard, or queue it for its owner
+ * @param g
+ */
+template<size_t K>
+void Shard_Worker<K>::add(const Packed_State<K>& g) {
+	const uint64_t h = hash(g);
+	const uint to = this->owner(h);
+	if (to == w) {
+		if (!R.insert(g, h))
+			result.duplicates++;
+		return;
+	}
+	out[to].emplace_back(g);
+	if (out[to].size() == BATCH)
+		this->flush(to);
+}
+
+/**
+ * @brief send the batch of a worker; while its ring is full, receive, so
+ *        that two workers sending to each other cannot block each other
+ * @param to
+ */
+template<size_t K>
+void Shard_Worker<K>::flush(const uint& to) {
+	auto& batch = out[to];
+	region.work().fetch_add(batch.size());
+	auto& ring = region.ring(w, to);
+	while (!ring.push(batch.data(), batch.size())) {
+		this->receive();
+		::sched_yield();
+	}
+	result.sent += batch.size();
+	batch.clear();
+}
+
+/**
+ * @brief store the states of all incoming rings
+ */
+template<size_t K>
+void Shard_Worker<K>::receive() {
+	ulong k = 0;
+	for (uint from = 0; from < P; ++from)
+		if (from != w)
+			k += region.ring(from, w).pop(in);
+	for (const auto& g : in)
+		if (!R.insert(g, hash(g)))
+			result.duplicates++;
+	in.clear();
+	if (k > 0)
+		region.work().fetch_sub(k);
+}
+
+template<size_t K>
+bool Shard_Worker<K>::has_incoming() {
+	for (uint from = 0; from < P; ++from)
+		if (from != w && !region.ring(from, w).empty())
+			return true;
+	return false;
+}
+
+/**
+ * @brief publish the result of the shard
+ */
+template<size_t K>
+void Shard_Worker<K>::finish() {
+	result.states = R.size();
+	result.bytes = R.bytes();
+	region.result(w) = result;
+	char* reached = region.reached(w);
+	for (size_t i = 0; i < R.size(); ++i) {
+		const Shared_State share = packing.share(R[i]);
+		for (Local_State l = 0; l < model.L(); ++l)
+			if (packing.get(R[i], l) > 0)
+				reached[model.index(Thread_State(share, l))] = 1;
+	}
+}
+
+} /* namespace */
+
+/////////////////////// the search ////////////////////////////////
+
+/**
+ * @brief a forward search by P = processes worker processes. The states are
+ *        packed (see Packed_State) and sharded by their hash: each worker
+ *        stores and expands the states of its shard, in its own memory, and
+ *        sends the successors of other shards through lock-free rings in
+ *        shared memory, see Shard_Worker. Each worker is pinned to a CPU,
+ *        so with the default first-touch NUMA policy its visited set and
+ *        its incoming rings stay on its node. It reaches the same states as
+ *        standard_FWS.
+ * @param n: number of threads at the initial states
+ * @param s: maximum number of spawn transition could be fired
+ * @param packing
+ * @return Search_Result
+ */
+template<size_t K>
+Search_Result FWS::sharded_FWS(const size_p& n, const size_p& s,
+		const Packing& packing) {
+	Stopwatch watch;
+	vector<bool> reached;
+	this->begin_search(n, s, reached);
+	const uint P = processes;
+	Shared_Region<K> region(P, model.S() * model.L());
+	const auto init = packing.pack<K>(init_ts, n);
+
+	cout.flush(); /// or the workers would print the buffered output again
+	std::cerr.flush();
+	vector<pid_t> workers;
+	for (uint w = 0; w < P; ++w) {
+		const pid_t pid = ::fork();
+		if (pid < 0) {
+			for (const auto& p : workers)
+				::kill(p, SIGKILL);
+			for (const auto& p : workers)
+				::waitpid(p, nullptr, 0);
+			throw CONTROL::Error("cannot fork a worker process");
+		}
+		if (pid == 0) {
+			::signal(SIGINT, SIG_DFL); /// stopped with the others, not alone
+			::signal(SIGTERM, SIG_DFL);
+			int code = 0;
+			try {
+				Shard_Worker<K>(model, packing, region, P, w, ulong(n) + s).run(
+						init);
+			} catch (...) {
+				code = 1;
+			}
+			::_exit(code);
+		}
+		workers.emplace_back(pid);
+	}
+	bool failed = false;
+	for (size_t left = workers.size(); left > 0; --left) {
+		int status;
+		const pid_t pid = ::waitpid(-1, &status, 0);
+		if (pid < 0)
+			break;
+		if (!failed && (!WIFEXITED(status) || WEXITSTATUS(status) != 0)) {
+			failed = true; /// the others would wait for it forever
+			for (const auto& p : workers)
+				if (p != pid)
+					::kill(p, SIGKILL);
+		}
+	}
+	if (failed)
+		throw CONTROL::Error("a worker process of the sharded search failed");
+
+	Search_Result result;
+	result.reachable.assign(model.S(), vector<bool>(model.L(), false));
+	Search_Profile profile(n, s);
+	ulong bytes = 0;
+	for (uint w = 0; w < P; ++w) {
+		const auto& r = region.result(w);
+		profile.states += r.states;
+		profile.expanded += r.expanded;
+		profile.edges += r.edges;
+		profile.duplicates += r.duplicates;
+		profile.spawns += r.spawns;
+		bytes += r.bytes;
+		const char* marks = region.reached(w);
+		for (size_s s = 0; s < model.S(); ++s)
+			for (size_l l = 0; l < model.L(); ++l)
+				if (marks[model.index(Thread_State(s, l))])
+					result.reachable[s][l] = true;
+	}
+	result.reachable[init_ts.share][init_ts.local] = true;
+	result.states = profile.states;
+	result.mode = State_Store_Base::EXACT;
+	if (stats != nullptr) {
+		profile.time = watch.elapsed();
+		profile.store = "sharded";
+		profile.counter = 0;
+		profile.bytes.emplace_back("visited_set", bytes);
+		profile.bytes.emplace_back("rings", ulong(P) * P * sizeof(Ring<K> ));
+		profile.bytes.emplace_back("TTD", model.bytes());
+		stats->add_phase("search", profile.time);
+		stats->add_search(profile);
+	}
+	return result;
+}
+
+template class Shared_Region<1> ;
+template class Shared_Region<2> ;
+template class Shared_Region<3> ;
+template class Shared_Region<4> ;
+template Search_Result FWS::sharded_FWS<1>(const size_p&, const size_p&,
+		const Packing&);
+template Search_Result FWS::sharded_FWS<2>(const size_p&, const size_p&,
+		const Packing&);
+template Search_Result FWS::sharded_FWS<3>(const size_p&, const size_p&,
+		const Packing&);
+template Search_Result FWS::sharded_FWS<4>(const size_p&, const size_p&,
+		const Packing&);
+
+} /* namespace sura */
@@ -0,0 +1,117 @@
+/*
+ * shard.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef SHARD_HH_
+#define SHARD_HH_
+
+#include <atomic>
+
+#include "packed.hh"
+
+namespace sura {
+
+/**
+ * @brief a single-producer single-consumer ring of packed states, in memory
+ *        shared by two processes. The producer writes a batch of states to
+ *        the slots behind tail and then publishes them by advancing tail; the
+ *        consumer copies the states between head and tail and then frees
+ *        their slots by advancing head. head and tail live on separate cache
+ *        lines, and neither side ever waits for a lock.
+ */
+template<size_t K>
+struct Ring {
+	/// states per ring, a power of 2
+	static const uint64_t SLOTS = 1 << 12;
+
+	alignas(64) std::atomic<uint64_t> head; /// written by the consumer only
+	alignas(64) std::atomic<uint64_t> tail; /// written by the producer only
+	alignas(64) Packed_State<K> slots[SLOTS];
+
+	/// append k states, or nothing if they do not fit
+	bool push(const Packed_State<K>* batch, const size_t& k) {
+		const uint64_t t = tail.load(std::memory_order_relaxed);
+		if (t + k - head.load(std::memory_order_acquire) > SLOTS)
+			return false;
+		for (size_t i = 0; i < k; ++i)
+			slots[(t + i) & (SLOTS - 1)] = batch[i];
+		tail.store(t + k, std::memory_order_release);
+		return true;
+	}
+
+	/// move all states to the end of out; the number of states moved
+	size_t pop(vector<Packed_State<K>>& out) {
+		const uint64_t h = head.load(std::memory_order_relaxed);
+		const uint64_t t = tail.load(std::memory_order_acquire);
+		for (uint64_t i = h; i < t; ++i)
+			out.emplace_back(slots[i & (SLOTS - 1)]);
+		head.store(t, std::memory_order_release);
+		return t - h;
+	}
+
+	inline bool empty() const {
+		return head.load(std::memory_order_relaxed)
+				== tail.load(std::memory_order_acquire);
+	}
+};
+
+/// the counters of one worker of a sharded search
+struct Shard_Result {
+	ulong states;     /// the states of its shard
+	ulong expanded;
+	ulong edges;
+	ulong duplicates; /// successors of its shard reached before
+	ulong spawns;
+	ulong sent;       /// successors sent to other shards
+	ulong bytes;      /// of its visited set
+};
+
+/**
+ * @brief the memory shared by the processes of a sharded search, mapped
+ *        before they are forked: the termination counter, a ring from every
+ *        worker to every other, and the result of every worker. A worker
+ *        touches its incoming rings before any worker sends, so that with a
+ *        first-touch NUMA policy they are placed on its node.
+ */
+template<size_t K>
+class Shared_Region {
+public:
+	Shared_Region(const uint& P, const size_t& thread_states);
+	Shared_Region(const Shared_Region&) = delete;
+	Shared_Region& operator=(const Shared_Region&) = delete;
+	~Shared_Region();
+
+	/// the number of workers that are active, plus the states in transit
+	inline std::atomic<uint64_t>& work() {
+		return *reinterpret_cast<std::atomic<uint64_t>*>(base);
+	}
+	/// the number of workers that have touched their rings
+	inline std::atomic<uint64_t>& ready() {
+		return *reinterpret_cast<std::atomic<uint64_t>*>(base + 64);
+	}
+	inline Ring<K>& ring(const uint& from, const uint& to) {
+		return *reinterpret_cast<Ring<K>*>(base + rings
+				+ (ulong(from) * P + to) * sizeof(Ring<K> ));
+	}
+	inline Shard_Result& result(const uint& w) {
+		return *reinterpret_cast<Shard_Result*>(base + results
+				+ w * sizeof(Shard_Result));
+	}
+	/// the thread states reached by worker w, one byte each
+	inline char* reached(const uint& w) {
+		return base + marks + w * thread_states;
+	}
+
+private:
+	uint P;
+	size_t thread_states;
+	size_t rings, results, marks, size; /// offsets and size of the mapping
+	char* base;
+};
+
+} /* namespace sura */
+
+#endif /* SHARD_HH_ */
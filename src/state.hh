@@ -11,6 +11,8 @@
 #include "heads.hh"
 #include "algs.hh"
 
+#include <cstdint>
+
 namespace sura {
 
 /// define local state
@@ -23,8 +25,8 @@ typedef unsigned short Shared_State;
 /// define size of shared states
 typedef unsigned short size_s;
 
-/// define the counter of thread state
-typedef unsigned short size_p;
+/// define the number of threads, and the widest counter of thread states
+typedef unsigned int size_p;
 
 /// define the thread state id
 typedef unsigned int thread_state_id;
@@ -146,38 +148,63 @@ inline bool operator>(const Thread_State& t1, const Thread_State& t2) {
 	return t2 < t1;
 }
 
-/// class global state
-typedef map<Local_State, size_p> Locals;
+/// the narrowest counter type that holds counts up to bound: global states
+/// are instantiated with uint8_t, uint16_t or uint32_t counters
+enum Counter_Width {
+	COUNTER_8 = 1, COUNTER_16 = 2, COUNTER_32 = 4
+};
+
+inline Counter_Width counter_width(const unsigned long& bound) {
+	if (bound <= UINT8_MAX)
+		return COUNTER_8;
+	if (bound <= UINT16_MAX)
+		return COUNTER_16;
+	if (bound <= UINT32_MAX)
+		return COUNTER_32;
+	throw CONTROL::Error("too many threads: " + std::to_string(bound));
+}
 
-class Global_State {
+/// class global state, whose counters of local states have type C
+template<class C> using Locals_T = map<Local_State, C>;
+
+template<class C>
+class Global_State_T {
 public:
+	typedef C counter;
+
 	Shared_State share;
-	Locals locals;
+	Locals_T<C> locals;
 
-	inline Global_State();
-	inline Global_State(const Thread_State& t);
-	inline Global_State(const Thread_State& t, const size_p &n);
-	inline Global_State(const Shared_State& share, const Locals& locals);
-	virtual ~Global_State() {
+	inline Global_State_T();
+	inline Global_State_T(const Thread_State& t);
+	inline Global_State_T(const Thread_State& t, const size_p &n);
+	inline Global_State_T(const Shared_State& share, const Locals_T<C>& locals);
+	virtual ~Global_State_T() {
 	}
 
 	ostream& to_stream(ostream& out = cout, const string& sep = "|") const;
 };
 
+/// global states with the widest counters
+typedef Locals_T<size_p> Locals;
+typedef Global_State_T<size_p> Global_State;
+
 /**
  * @brief default constructor: initialize
  *        share  = 0
  *        locals = empty map
  */
-inline Global_State::Global_State() :
-		share(0), locals(Locals()) {
+template<class C>
+inline Global_State_T<C>::Global_State_T() :
+		share(0), locals(Locals_T<C>()) {
 }
 
 /**
  * @brief constructor with a thread state
  * @param t
  */
-inline Global_State::Global_State(const Thread_State& t) :
+template<class C>
+inline Global_State_T<C>::Global_State_T(const Thread_State& t) :
 		share(t.share) {
 	locals[t.local] = 1;
 }
@@ -187,7 +214,9 @@ inline Global_State::Global_State(const Thread_State& t) :
  * @param t
  * @param n
  */
-inline Global_State::Global_State(const Thread_State& t, const size_p &n) :
+template<class C>
+inline Global_State_T<C>::Global_State_T(const Thread_State& t,
+		const size_p &n) :
 		share(t.share) {
 	locals[t.local] = n;
 }
@@ -197,8 +226,9 @@ inline Global_State::Global_State(const Thread_State& t, const size_p &n) :
  * @param share : shared state
  * @param locals: local states represented in counter abstraction form
  */
-inline Global_State::Global_State(const Shared_State& share,
-		const Locals& locals) :
+template<class C>
+inline Global_State_T<C>::Global_State_T(const Shared_State& share,
+		const Locals_T<C>& locals) :
 		share(share), locals(locals) {
 }
 
@@ -208,10 +238,12 @@ inline Global_State::Global_State(const Shared_State& share,
  * @param sep
  * @return ostream
  */
-inline ostream& Global_State::to_stream(ostream& out, const string& sep) const {
+template<class C>
+inline ostream& Global_State_T<C>::to_stream(ostream& out,
+		const string& sep) const {
 	out << "<" << this->share << "|";
 	for (auto iloc = this->locals.begin(); iloc != this->locals.end(); ++iloc) {
-		out << "(" << iloc->first << "," << iloc->second << ")";
+		out << "(" << iloc->first << "," << ulong(iloc->second) << ")";
 	}
 	out << ">";
 	return out;
@@ -223,7 +255,8 @@ inline ostream& Global_State::to_stream(ostream& out, const string& sep) const {
  * @param g
  * @return
  */
-inline ostream& operator<<(ostream& out, const Global_State& s) {
+template<class C>
+inline ostream& operator<<(ostream& out, const Global_State_T<C>& s) {
 	return s.to_stream(out);
 }
 
@@ -235,7 +268,8 @@ inline ostream& operator<<(ostream& out, const Global_State& s) {
  * 		   true : if s1 < s2
  * 		   false: otherwise
  */
-inline bool operator<(const Global_State& s1, const Global_State& s2) {
+template<class C>
+inline bool operator<(const Global_State_T<C>& s1, const Global_State_T<C>& s2) {
 	if (s1.share == s2.share) {
 		return COMPARE::compare_map(s1.locals, s2.locals) == -1;
 	} else {
@@ -251,7 +285,8 @@ inline bool operator<(const Global_State& s1, const Global_State& s2) {
  * 		   true : if s1 > s2
  * 		   false: otherwise
  */
-inline bool operator>(const Global_State& s1, const Global_State& s2) {
+template<class C>
+inline bool operator>(const Global_State_T<C>& s1, const Global_State_T<C>& s2) {
 	return s2 < s1;
 }
 
@@ -263,7 +298,9 @@ inline bool operator>(const Global_State& s1, const Global_State& s2) {
  * 		   true : if s1 == s2
  * 		   false: otherwise
  */
-inline bool operator==(const Global_State& s1, const Global_State& s2) {
+template<class C>
+inline bool operator==(const Global_State_T<C>& s1,
+		const Global_State_T<C>& s2) {
 	if (s1.share == s2.share) {
 		if (s1.locals.size() == s2.locals.size()) {
 			auto is1 = s1.locals.begin(), is2 = s2.locals.begin();
@@ -286,7 +323,9 @@ inline bool operator==(const Global_State& s1, const Global_State& s2) {
  * 		   true : if s1 != s2
  * 		   false: otherwise
  */
-inline bool operator!=(const Global_State& s1, const Global_State& s2) {
+template<class C>
+inline bool operator!=(const Global_State_T<C>& s1,
+		const Global_State_T<C>& s2) {
 	return !(s1 == s2);
 }
 
@@ -0,0 +1,162 @@
+/*
+ * stats.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include <iomanip>
+
+#include "stats.hh"
+#include "algs.hh"
+
+namespace sura {
+
+/**
+ * @brief quote and escape a string for JSON
+ * @param s
+ * @return string
+ */
+static string json_string(const string& s) {
+	string result = "\"";
+	for (const char& c : s) {
+		switch (c) {
+		case '"':
+			result += "\\\"";
+			break;
+		case '\\':
+			result += "\\\\";
+			break;
+		case '\n':
+			result += "\\n";
+			break;
+		case '\t':
+			result += "\\t";
+			break;
+		default:
+			if (uint((unsigned char) c) < 0x20)
+				result += PPRINT::formatString(uint((unsigned char) c),
+						"\\u%04x");
+			else
+				result += c;
+		}
+	}
+	return result + "\"";
+}
+
+/**
+ * @brief accumulate the time of a phase; phases keep the order of first use
+ * @param name
+ * @param seconds
+ */
+void Statistics::add_phase(const string& name, const double& seconds) {
+	for (auto& phase : phases) {
+		if (phase.first == name) {
+			phase.second += seconds;
+			return;
+		}
+	}
+	phases.emplace_back(name, seconds);
+}
+
+/**
+ * @brief record the profile of a finished search
+ * @param profile
+ */
+void Statistics::add_search(const Search_Profile& profile) {
+	searches.emplace_back(profile);
+}
+
+/**
+ * @brief record a piece of information about the run
+ * @param key
+ * @param value
+ */
+void Statistics::add_info(const string& key, const string& value) {
+	info.emplace_back(key, value);
+}
+
+/**
+ * @brief print all statistics as a JSON object
+ * @param out
+ */
+void Statistics::to_json(ostream& out) const {
+	const auto flags = out.flags();
+	const auto precision = out.precision(9);
+	out << "{\n";
+	for (const auto& i : info)
+		out << "  " << json_string(i.first) << ": " << json_string(i.second)
+				<< ",\n";
+
+	out << "  \"phases\": {";
+	for (auto p = phases.begin(); p != phases.end(); ++p)
+		out << (p == phases.begin() ? "" : ",") << "\n    "
+				<< json_string(p->first) << ": " << p->second;
+	out << "\n  },\n";
+
+	out << "  \"searches\": [";
+	for (auto s = searches.begin(); s != searches.end(); ++s) {
+		out << (s == searches.begin() ? "" : ",") << "\n    {\n";
+		out << "      \"n\": " << s->n << ",\n";
+		out << "      \"s\": " << s->s << ",\n";
+		out << "      \"time\": " << s->time << ",\n";
+		out << "      \"store\": " << json_string(s->store) << ",\n";
+		out << "      \"exact\": " << (s->exact ? "true" : "false") << ",\n";
+		out << "      \"counter_bytes\": " << s->counter << ",\n";
+		out << "      \"states\": " << s->states << ",\n";
+		out << "      \"expanded\": " << s->expanded << ",\n";
+		out << "      \"edges\": " << s->edges << ",\n";
+		out << "      \"duplicates\": " << s->duplicates << ",\n";
+		out << "      \"spawns\": " << s->spawns << ",\n";
+		out << "      \"peak_frontier\": " << s->peak_frontier << ",\n";
+		if (!s->by_share.empty()) {
+			out << "      \"states_by_share\": [";
+			for (size_t i = 0; i < s->by_share.size(); ++i)
+				out << (i == 0 ? "" : ", ") << s->by_share[i];
+			out << "],\n";
+		}
+		if (!s->notes.empty()) {
+			out << "      \"notes\": [";
+			for (size_t i = 0; i < s->notes.size(); ++i)
+				out << (i == 0 ? "" : ", ") << json_string(s->notes[i]);
+			out << "],\n";
+		}
+		out << "      \"states_per_second\": "
+				<< (s->time > 0 ? s->states / s->time : 0) << ",\n";
+
+		out << "      \"bytes\": {";
+		for (auto b = s->bytes.begin(); b != s->bytes.end(); ++b)
+			out << (b == s->bytes.begin() ? "" : ",") << "\n        "
+					<< json_string(b->first) << ": " << b->second;
+		out << "\n      },\n";
+
+		out << "      \"levels\": [";
+		for (auto l = s->levels.begin(); l != s->levels.end(); ++l)
+			out << (l == s->levels.begin() ? "" : ",") << "\n        "
+					<< "{\"depth\": " << l->depth << ", \"expanded\": "
+					<< l->expanded << ", \"edges\": " << l->edges
+					<< ", \"duplicates\": " << l->duplicates
+					<< ", \"spawns\": " << l->spawns << ", \"time\": "
+					<< l->time << "}";
+		out << "\n      ]\n    }";
+	}
+	out << "\n  ],\n";
+	out << "  \"peak_rss_kb\": " << Memory::peak_rss() << "\n";
+	out << "}" << endl;
+	out.flags(flags);
+	out.precision(precision);
+}
+
+/**
+ * @brief write all statistics as JSON to a file
+ * @param filename
+ */
+void Statistics::to_json(const string& filename) const {
+	ofstream out(filename.c_str());
+	if (!out.is_open())
+		throw CONTROL::Error("cannot open " + filename);
+	this->to_json(out);
+	out.close();
+}
+
+} /* namespace sura */
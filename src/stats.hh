@@ -0,0 +1,102 @@
+/*
+ * stats.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef STATS_HH_
+#define STATS_HH_
+
+#include <chrono>
+
+#include "heads.hh"
+
+namespace sura {
+
+/// a wall-clock stopwatch with sub-microsecond resolution
+class Stopwatch {
+public:
+	inline Stopwatch() :
+			start(std::chrono::steady_clock::now()) {
+	}
+
+	inline void restart() {
+		start = std::chrono::steady_clock::now();
+	}
+
+	/// seconds elapsed since construction or the last restart
+	inline double elapsed() const {
+		return std::chrono::duration<double>(
+				std::chrono::steady_clock::now() - start).count();
+	}
+
+private:
+	std::chrono::steady_clock::time_point start;
+};
+
+/// the profile of one BFS level
+struct Level_Profile {
+	uint depth;       /// distance from the initial state
+	ulong expanded;   /// states expanded at this level
+	ulong edges;      /// transitions fired from these states
+	ulong duplicates; /// successors that were reached before
+	ulong spawns;     /// spawn transitions fired
+	double time;      /// seconds spent on this level
+};
+
+/// the counters of one forward search
+struct Search_Profile {
+	ulong n;             /// threads at the initial state
+	ulong s;             /// maximum number of spawn transitions
+	ulong states;        /// reachable global states
+	ulong expanded;      /// states taken from the worklist
+	ulong edges;         /// transitions fired
+	ulong duplicates;    /// successors that were reached before
+	ulong spawns;        /// spawn transitions fired
+	ulong peak_frontier; /// maximum size of the worklist
+	double time;         /// seconds spent on the search
+	string store;        /// representation of the visited set at the end
+	uint counter;        /// bytes of a counter of the global states
+	bool exact;          /// false if states may have been missed
+	vector<Level_Profile> levels;
+	vector<std::pair<string, ulong>> bytes; /// memory of major structures
+	vector<ulong> by_share; /// states per shared state, if the visited set
+	                        /// is partitioned by them
+	vector<string> notes;   /// e.g., the switches of the memory budget
+
+	Search_Profile(culong& n, culong& s) :
+			n(n), s(s), states(0), expanded(0), edges(0), duplicates(0), spawns(
+					0), peak_frontier(0), time(0), store("exact"), counter(0), exact(
+					true) {
+	}
+};
+
+/**
+ * @brief the statistics of a run: phase timers and the profile of every
+ *        search. A search records its profile only when a Statistics object
+ *        is attached to it, so collecting nothing costs nothing.
+ */
+class Statistics {
+public:
+	Statistics() {
+	}
+	~Statistics() {
+	}
+
+	void add_phase(const string& name, const double& seconds);
+	void add_search(const Search_Profile& profile);
+	void add_info(const string& key, const string& value);
+
+	void to_json(ostream& out) const;
+	void to_json(const string& filename) const;
+
+private:
+	vector<std::pair<string, string>> info;    /// model, settings, ...
+	vector<std::pair<string, double>> phases; /// in order of first use
+	vector<Search_Profile> searches;
+};
+
+} /* namespace sura */
+
+#endif /* STATS_HH_ */
@@ -0,0 +1,518 @@
+/*
+ * store.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "store.hh"
+
+namespace sura {
+
+/////////////////////////////// State_Store ///////////////////////////////
+
+template<class C>
+State_Store<C>::State_Store() :
+		S(0), L(0), store_mode(EXACT), count(0), locals(0) {
+}
+
+template<class C>
+State_Store<C>::State_Store(const size_s& S, const size_l& L,
+		const shared_ptr<const Zobrist>& zobrist) :
+		S(S), L(L), zobrist(zobrist), store_mode(EXACT), count(0), locals(0), partitions(
+				S), sizes(S, 0) {
+}
+
+/**
+ * @brief insert a global state
+ * @param g
+ * @param h: the Zobrist hash of g
+ * @return bool
+ * 			true : g is new (in BITSTATE mode: probably new)
+ * 			false: g was inserted before (in BITSTATE mode: maybe)
+ */
+template<class C>
+bool State_Store<C>::insert(const Global_State_T<C>& g, const uint64_t& h) {
+	if (store_mode == EXACT) {
+		const uint32_t id = this->intern(g.locals, h ^ zobrist->shared(g.share));
+		if (!this->insert_pair(g.share, id))
+			return false;
+		++count;
+		return true;
+	}
+
+	bool is_new;
+	if (store_mode == COMPRESSED) {
+		string code;
+		State_Codec::encode(g, code);
+		is_new = this->insert_compressed(code, h);
+	} else {
+		is_new = this->insert_bits(h);
+	}
+	if (is_new) {
+		++count;
+		this->mark(g);
+	}
+	return is_new;
+}
+
+/**
+ * @brief the ID of a counter vector, interned if it is new
+ * @param locals
+ * @param h: the hash of locals
+ * @return uint32_t
+ */
+template<class C>
+uint32_t State_Store<C>::intern(const Locals_T<C>& locals, const uint64_t& h) {
+	if (10 * (interned.size() + 1) > 7 * vector_table.size())
+		this->grow_vector_table();
+	const uint64_t mask = vector_table.size() - 1;
+	for (uint64_t i = h & mask;; i = (i + 1) & mask) {
+		const uint32_t id = vector_table[i];
+		if (id == 0) {
+			if (interned.size() == UINT32_MAX)
+				throw CONTROL::Error("State_Store: too many counter vectors");
+			vector_table[i] = interned.size() + 1;
+			interned.emplace_back(locals);
+			vector_hashes.emplace_back(h);
+			this->locals += locals.size();
+			return interned.size() - 1;
+		}
+		if (vector_hashes[id - 1] == h && interned[id - 1] == locals)
+			return id - 1;
+	}
+}
+
+/**
+ * @brief insert the state (share, vector id) into the partition of share
+ * @param share
+ * @param id
+ * @return bool: true if the state is new
+ */
+template<class C>
+bool State_Store<C>::insert_pair(const Shared_State& share,
+		const uint32_t& id) {
+	auto& part = partitions[share];
+	if (10 * (sizes[share] + 1) > 7 * part.size())
+		this->grow_partition(share);
+	const uint64_t mask = part.size() - 1;
+	for (uint64_t i = vector_hashes[id] & mask;; i = (i + 1) & mask) {
+		if (part[i] == 0) {
+			part[i] = id + 1;
+			++sizes[share];
+			return true;
+		}
+		if (part[i] == id + 1)
+			return false;
+	}
+}
+
+/**
+ * @brief double the table of counter vectors and rehash
+ */
+template<class C>
+void State_Store<C>::grow_vector_table() {
+	vector<uint32_t>(std::max<size_t>(1024, 2 * vector_table.size()), 0).swap(
+			vector_table);
+	const uint64_t mask = vector_table.size() - 1;
+	for (uint32_t id = 0; id < interned.size(); ++id) {
+		auto i = vector_hashes[id] & mask;
+		while (vector_table[i] != 0)
+			i = (i + 1) & mask;
+		vector_table[i] = id + 1;
+	}
+}
+
+/**
+ * @brief double the partition of a shared state and rehash it
+ * @param share
+ */
+template<class C>
+void State_Store<C>::grow_partition(const Shared_State& share) {
+	auto& part = partitions[share];
+	vector<uint32_t> old(std::max<size_t>(16, 2 * part.size()), 0);
+	old.swap(part);
+	const uint64_t mask = part.size() - 1;
+	for (const auto& id : old) {
+		if (id == 0)
+			continue;
+		auto i = vector_hashes[id - 1] & mask;
+		while (part[i] != 0)
+			i = (i + 1) & mask;
+		part[i] = id;
+	}
+}
+
+/**
+ * @brief insert an encoded state into the compressed hash table
+ * @param code
+ * @param h: the hash of the state
+ * @return bool: true if code is new
+ */
+template<class C>
+bool State_Store<C>::insert_compressed(const string& code, const uint64_t& h) {
+	if (10 * (count + 1) > 7 * table.size())
+		this->grow_table();
+	const uint64_t mask = table.size() - 1;
+	for (uint64_t i = h & mask;;
+			i = (i + 1) & mask) {
+		if (table[i] == 0) {
+			table[i] = arena.size() + 1;
+			State_Codec::put_varint(code.size(), arena);
+			arena += code;
+			return true;
+		}
+		const char* p = arena.data() + table[i] - 1;
+		const auto len = State_Codec::get_varint(p);
+		if (len == code.size() && std::memcmp(p, code.data(), len) == 0)
+			return false;
+	}
+}
+
+/**
+ * @brief double the compressed hash table and rehash
+ */
+template<class C>
+void State_Store<C>::grow_table() {
+	vector<uint64_t> old(std::max<size_t>(1024, 2 * table.size()), 0);
+	old.swap(table);
+	const uint64_t mask = table.size() - 1;
+	for (const auto& offset : old) {
+		if (offset == 0)
+			continue;
+		auto i = this->hash_at(offset) & mask;
+		while (table[i] != 0)
+			i = (i + 1) & mask;
+		table[i] = offset;
+	}
+}
+
+/**
+ * @brief the hash of the state stored at an arena offset
+ * @param offset: arena offset + 1
+ * @return uint64_t
+ */
+template<class C>
+uint64_t State_Store<C>::hash_at(const uint64_t& offset) const {
+	const char* p = arena.data() + offset - 1;
+	State_Codec::get_varint(p);
+	return zobrist->hash(State_Codec::decode<C>(p));
+}
+
+/**
+ * @brief set the bits of a state in the bitstate table
+ * @param h: hash of the state
+ * @return bool: true if at least one bit was unset, i.e., the state is new
+ */
+template<class C>
+bool State_Store<C>::insert_bits(const uint64_t& h) {
+	const uint64_t m = bits.size() * 64;
+	const uint64_t h1 = h, h2 = (h >> 32) | (h << 32) | 1;
+	bool is_new = false;
+	for (uint k = 0; k < BIT_HASHES; ++k) {
+		const uint64_t b = (h1 + k * h2) % m;
+		const uint64_t bit = uint64_t(1) << (b & 63);
+		if ((bits[b >> 6] & bit) == 0) {
+			bits[b >> 6] |= bit;
+			is_new = true;
+		}
+	}
+	return is_new;
+}
+
+/**
+ * @brief mark the thread states of g as reached
+ * @param g
+ */
+template<class C>
+void State_Store<C>::mark(const Global_State_T<C>& g) {
+	for (const auto& p : g.locals)
+		marks[g.share * L + p.first] = true;
+}
+
+/**
+ * @brief move all states of an EXACT store into the compressed table
+ */
+template<class C>
+void State_Store<C>::compress() {
+	if (store_mode != EXACT)
+		return;
+	marks.assign(S * L, false);
+	store_mode = COMPRESSED;
+	count = 0;
+	for (size_s s = 0; s < S; ++s) {
+		for (const auto& id : partitions[s])
+			if (id != 0)
+				this->insert(Global_State_T<C>(s, interned[id - 1]),
+						zobrist->shared(s) ^ vector_hashes[id - 1]);
+		vector<uint32_t>().swap(partitions[s]);
+		sizes[s] = 0;
+	}
+	vector<Locals_T<C>>().swap(interned);
+	vector<uint64_t>().swap(vector_hashes);
+	vector<uint32_t>().swap(vector_table);
+	locals = 0;
+}
+
+/**
+ * @brief move all states into a bitstate table of the given size. From now
+ *        on, the store is approximate
+ * @param bytes
+ */
+template<class C>
+void State_Store<C>::to_bitstate(culong& bytes) {
+	if (store_mode == BITSTATE)
+		return;
+	this->compress();
+	bits.assign(std::max<ulong>(1, bytes / sizeof(uint64_t)), 0);
+	for (const auto& offset : table)
+		if (offset != 0)
+			this->insert_bits(this->hash_at(offset));
+	string().swap(arena);
+	vector<uint64_t>().swap(table);
+	store_mode = BITSTATE;
+}
+
+/**
+ * @brief estimate the bytes used by the store: every tree node of a counter
+ *        vector costs its payload plus the node header
+ * @return ulong
+ */
+template<class C>
+ulong State_Store<C>::bytes() const {
+	const ulong node = 4 * sizeof(void*); /// color, parent, left, right
+	switch (store_mode) {
+	case EXACT: {
+		ulong ids = 0;
+		for (const auto& part : partitions)
+			ids += part.size();
+		return ids * sizeof(uint32_t)
+				+ partitions.size() * (sizeof(vector<uint32_t>) + sizeof(ulong))
+				+ vector_table.size() * sizeof(uint32_t)
+				+ vector_hashes.capacity() * sizeof(uint64_t)
+				+ interned.capacity() * sizeof(Locals_T<C>)
+				+ locals * (node + sizeof(typename Locals_T<C>::value_type));
+	}
+	case COMPRESSED:
+		return arena.capacity() + table.size() * sizeof(uint64_t)
+				+ marks.size() / 8;
+	default:
+		return bits.size() * sizeof(uint64_t) + marks.size() / 8;
+	}
+}
+
+/**
+ * @brief extract all reachable thread states from the stored states. The
+ *        partitions of an EXACT store mark disjoint rows, so threads scan
+ *        them in parallel, each every threads-th shared state
+ * @param threads
+ * @return S x L bit matrix:
+ * 			R[s][l] = true : thread state (s, l) is reachable
+ * 			R[s][l] = false: thread state (s, l) is unreachable
+ */
+template<class C>
+vector<vector<bool>> State_Store<C>::reachable_TS(const uint& threads) const {
+	vector<vector<bool>> reached(S, vector<bool>(L, false));
+	if (store_mode == EXACT) {
+		auto scan = [&](const uint& first, const uint& step) {
+			for (size_s s = first; s < S; s += step)
+				for (const auto& id : partitions[s])
+					if (id != 0)
+						for (const auto& p : interned[id - 1])
+							reached[s][p.first] = true;
+		};
+		const uint T = std::max(1u, std::min<uint>(threads, S));
+		vector<std::thread> workers;
+		for (uint w = 1; w < T; ++w)
+			workers.emplace_back(scan, w, T);
+		scan(0, T);
+		for (auto& w : workers)
+			w.join();
+	} else {
+		for (size_s s = 0; s < S; ++s)
+			for (size_l l = 0; l < L; ++l)
+				reached[s][l] = marks[s * L + l];
+	}
+	return reached;
+}
+
+/**
+ * @brief the states of an EXACT store, in no particular order
+ * @return vector<Global_State_T<C>>
+ */
+template<class C>
+vector<Global_State_T<C>> State_Store<C>::states() const {
+	vector<Global_State_T<C>> states;
+	states.reserve(count);
+	for (size_s s = 0; s < S; ++s)
+		for (const auto& id : partitions[s])
+			if (id != 0)
+				states.emplace_back(s, interned[id - 1]);
+	return states;
+}
+
+string State_Store_Base::mode_name(const Mode& mode) {
+	switch (mode) {
+	case EXACT:
+		return "exact";
+	case COMPRESSED:
+		return "compressed";
+	default:
+		return "bitstate";
+	}
+}
+
+/////////////////////////////// Worklist ///////////////////////////////
+
+template<class C>
+Worklist<C>::Worklist() :
+		length(0), locals(0), file(nullptr), read_pos(0), write_pos(0), head_pos(
+				0) {
+}
+
+template<class C>
+Worklist<C>::~Worklist() {
+	if (file != nullptr)
+		std::fclose(file);
+}
+
+/**
+ * @brief append g to the end of the worklist
+ * @param g
+ */
+template<class C>
+void Worklist<C>::push(const Global_State_T<C>& g) {
+	++length;
+	if (file == nullptr) {
+		memory.emplace_back(g);
+		locals += g.locals.size();
+	} else {
+		State_Codec::encode(g, tail);
+		if (tail.size() >= BLOCK)
+			this->flush_tail();
+	}
+}
+
+/**
+ * @brief remove and return the first state of the worklist
+ * @return Global_State_T<C>
+ */
+template<class C>
+Global_State_T<C> Worklist<C>::pop() {
+	__SAFE_ASSERT__ (length > 0);
+	--length;
+	if (!memory.empty()) {
+		Global_State_T<C> g = memory.front();
+		memory.pop_front();
+		locals -= g.locals.size();
+		return g;
+	}
+	if (head_pos >= head.size() && !this->load_head())
+		throw CONTROL::Error("Worklist::pop: internal");
+	const char* p = head.data() + head_pos;
+	Global_State_T<C> g = State_Codec::decode<C>(p);
+	head_pos = p - head.data();
+	return g;
+}
+
+/**
+ * @brief move the worklist to a temporary file, and keep it there from now on
+ */
+template<class C>
+void Worklist<C>::spill() {
+	if (file != nullptr)
+		return;
+	file = std::tmpfile();
+	if (file == nullptr)
+		throw CONTROL::Error("Worklist::spill: cannot create temporary file");
+	for (const auto& g : memory) {
+		State_Codec::encode(g, tail);
+		if (tail.size() >= BLOCK)
+			this->flush_tail();
+	}
+	deque<Global_State_T<C>>().swap(memory);
+	locals = 0;
+}
+
+/**
+ * @brief write the tail block to the end of the file
+ */
+template<class C>
+void Worklist<C>::flush_tail() {
+	std::fseek(file, write_pos, SEEK_SET);
+	if (std::fwrite(tail.data(), 1, tail.size(), file) != tail.size())
+		throw CONTROL::Error("Worklist: cannot write the spilled worklist");
+	write_pos += tail.size();
+	block_sizes.push_back(tail.size());
+	tail.clear();
+}
+
+/**
+ * @brief make the next block the head: from the file if it has one, from
+ *        the tail otherwise
+ * @return bool: false if there is no state left
+ */
+template<class C>
+bool Worklist<C>::load_head() {
+	head_pos = 0;
+	if (!block_sizes.empty()) {
+		head.resize(block_sizes.front());
+		std::fseek(file, read_pos, SEEK_SET);
+		if (std::fread(&head[0], 1, head.size(), file) != head.size())
+			throw CONTROL::Error("Worklist: cannot read the spilled worklist");
+		this->reclaim(read_pos, head.size());
+		read_pos += head.size();
+		block_sizes.pop_front();
+		if (block_sizes.empty()) { /// caught up with the writer
+			std::fflush(file);
+			if (::ftruncate(::fileno(file), 0) == 0)
+				read_pos = write_pos = 0;
+		}
+		return true;
+	}
+	head.swap(tail);
+	tail.clear();
+	return !head.empty();
+}
+
+/**
+ * @brief free the disk blocks of a block of the file that was read, keeping
+ *        the offsets of the others. Best effort: a file system that cannot
+ *        punch holes keeps them until the file is emptied
+ * @param offset
+ * @param size
+ */
+template<class C>
+void Worklist<C>::reclaim(const long& offset, const size_t& size) {
+#ifdef FALLOC_FL_PUNCH_HOLE
+	::fallocate(::fileno(file), FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+			offset, size);
+#endif
+}
+
+/**
+ * @brief estimate the bytes of memory used by the worklist
+ * @return ulong
+ */
+template<class C>
+ulong Worklist<C>::bytes() const {
+	const ulong node = 4 * sizeof(void*);
+	return memory.size() * sizeof(Global_State_T<C>)
+			+ locals * (node + sizeof(typename Locals_T<C>::value_type))
+			+ head.capacity()
+			+ tail.capacity();
+}
+
+template class State_Store<uint8_t> ;
+template class State_Store<uint16_t> ;
+template class State_Store<uint32_t> ;
+template class Worklist<uint8_t> ;
+template class Worklist<uint16_t> ;
+template class Worklist<uint32_t> ;
+
+} /* namespace sura */
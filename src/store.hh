@@ -0,0 +1,246 @@
+/*
+ * store.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef STORE_HH_
+#define STORE_HH_
+
+#include <cstdint>
+
+#include "zobrist.hh"
+
+namespace sura {
+
+/**
+ * @brief a compact byte encoding of global states: the shared state, the
+ *        number of occupied locals, then per occupied local the distance to
+ *        the previous one and its counter, all as varints
+ */
+class State_Codec {
+public:
+	template<class C>
+	static void encode(const Global_State_T<C>& g, string& out);
+	template<class C>
+	static Global_State_T<C> decode(const char*& p);
+
+	static inline void put_varint(uint64_t v, string& out) {
+		while (v >= 0x80) {
+			out.push_back(char((v & 0x7f) | 0x80));
+			v >>= 7;
+		}
+		out.push_back(char(v));
+	}
+
+	static inline uint64_t get_varint(const char*& p) {
+		uint64_t v = 0;
+		for (uint shift = 0;; shift += 7) {
+			const unsigned char c = *p++;
+			v |= uint64_t(c & 0x7f) << shift;
+			if (c < 0x80)
+				return v;
+		}
+	}
+};
+
+/**
+ * @brief append the encoding of g to out
+ * @param g
+ * @param out
+ */
+template<class C>
+void State_Codec::encode(const Global_State_T<C>& g, string& out) {
+	put_varint(g.share, out);
+	put_varint(g.locals.size(), out);
+	Local_State prev = 0;
+	for (const auto& p : g.locals) {
+		put_varint(p.first - prev, out);
+		put_varint(p.second, out);
+		prev = p.first;
+	}
+}
+
+/**
+ * @brief decode the global state at p, and advance p behind it
+ * @param p
+ * @return Global_State_T<C>
+ */
+template<class C>
+Global_State_T<C> State_Codec::decode(const char*& p) {
+	Global_State_T<C> g;
+	g.share = get_varint(p);
+	const auto size = get_varint(p);
+	Local_State local = 0;
+	for (uint64_t i = 0; i < size; ++i) {
+		local += get_varint(p);
+		g.locals.emplace_hint(g.locals.end(), local, C(get_varint(p)));
+	}
+	return g;
+}
+
+/// the representations of a State_Store
+class State_Store_Base {
+public:
+	enum Mode {
+		EXACT, COMPRESSED, BITSTATE
+	};
+
+	static string mode_name(const Mode& mode);
+};
+
+/**
+ * @brief the set of reached global states with counters of type C. It starts EXACT, in two
+ *        levels: every distinct counter vector (the locals of a state) is
+ *        interned once in a hash-consed table and named by its index, and a
+ *        state is the pair (shared state, vector ID): the ID, in the
+ *        partition of its shared state. The S partitions are open-addressing
+ *        tables of 32-bit IDs that grow independently, so a lookup probes a
+ *        table of the states of one shared state only. States that differ
+ *        only in their shared state share one vector, and two states are
+ *        equal iff their pairs are. The store can be degraded to cheaper
+ *        representations:
+ *          COMPRESSED: every state is kept as a State_Codec byte string in
+ *                      one arena, indexed by an open-addressing hash table;
+ *          BITSTATE  : only k hash bits per state are kept (Holzmann's
+ *                      bitstate hashing). A hash collision makes a new state
+ *                      look visited, so the result becomes approximate.
+ *        Once the store leaves EXACT, it marks the thread states of every
+ *        inserted state, since BITSTATE cannot enumerate its states.
+ *        The caller passes the Zobrist hash of every inserted state, which
+ *        the search derives from the parent's; the hash of a vector, which
+ *        also places it in a partition, is that of the state XOR the key of
+ *        its shared state, so the store never hashes an EXACT state from
+ *        scratch.
+ */
+template<class C>
+class State_Store: public State_Store_Base {
+public:
+	State_Store();
+	State_Store(const size_s& S, const size_l& L,
+			const shared_ptr<const Zobrist>& zobrist);
+	~State_Store() {
+	}
+
+	bool insert(const Global_State_T<C>& g, const uint64_t& h);
+
+	void compress();
+	void to_bitstate(culong& bytes);
+
+	inline Mode mode() const {
+		return store_mode;
+	}
+	inline bool is_exact() const {
+		return store_mode != BITSTATE;
+	}
+	inline ulong size() const {
+		return count;
+	}
+	ulong bytes() const;
+
+	/// the states of an EXACT store
+	vector<Global_State_T<C>> states() const;
+	/// the distinct counter vectors of an EXACT store
+	inline ulong vectors() const {
+		return interned.size();
+	}
+	/// the mean number of local-counter pairs of a counter vector
+	inline ulong mean_locals() const {
+		return interned.empty() ? 0 : locals / interned.size();
+	}
+	/// the states of every shared state, in an EXACT store
+	inline const vector<ulong>& partition_sizes() const {
+		return sizes;
+	}
+	vector<vector<bool>> reachable_TS(const uint& threads = 1) const;
+
+private:
+	size_s S;
+	size_l L;
+	shared_ptr<const Zobrist> zobrist;
+	Mode store_mode;
+	ulong count;  /// number of (probably, if BITSTATE) distinct states
+	ulong locals; /// number of local-counter pairs of the interned vectors
+
+	vector<Locals_T<C>> interned;   /// EXACT: the counter vectors, by ID
+	vector<uint64_t> vector_hashes; /// EXACT: their Zobrist hashes
+	vector<uint32_t> vector_table;  /// EXACT: vector ID + 1, 0 is empty
+	vector<vector<uint32_t>> partitions; /// EXACT: by shared state, ID + 1
+	vector<ulong> sizes;                 /// EXACT: IDs in every partition
+
+
+	string arena;           /// COMPRESSED: encoded states back to back
+	vector<uint64_t> table; /// COMPRESSED: arena offset + 1, 0 is empty
+
+	vector<uint64_t> bits; /// BITSTATE
+	static const uint BIT_HASHES = 3;
+
+	vector<bool> marks; /// reached thread states, once not EXACT
+
+	uint32_t intern(const Locals_T<C>& locals, const uint64_t& h);
+	bool insert_pair(const Shared_State& share, const uint32_t& id);
+	void grow_vector_table();
+	void grow_partition(const Shared_State& share);
+	bool insert_compressed(const string& code, const uint64_t& h);
+	uint64_t hash_at(const uint64_t& offset) const;
+	void grow_table();
+	bool insert_bits(const uint64_t& h);
+	void mark(const Global_State_T<C>& g);
+};
+
+/**
+ * @brief the FIFO worklist of the search, of states with counters of type C. It keeps its states in memory
+ *        until it is spilled; from then on, all but a block at the head and
+ *        a block at the tail live in a temporary file. The file holds only
+ *        the blocks not read yet: a block read is punched out of it, and the
+ *        file is emptied whenever the reader catches up with the writer, so
+ *        its disk use is bounded by the states queued, not by all states
+ *        ever queued (where holes cannot be punched, it is reclaimed only
+ *        when emptied).
+ */
+template<class C>
+class Worklist {
+public:
+	Worklist();
+	Worklist(const Worklist&) = delete;
+	Worklist& operator=(const Worklist&) = delete;
+	~Worklist();
+
+	void push(const Global_State_T<C>& g);
+	Global_State_T<C> pop();
+
+	inline bool empty() const {
+		return length == 0;
+	}
+	inline ulong size() const {
+		return length;
+	}
+	inline bool is_spilled() const {
+		return file != nullptr;
+	}
+	ulong bytes() const;
+
+	void spill();
+
+private:
+	static const size_t BLOCK = 1 << 20; /// bytes of an on-disk block
+
+	ulong length;
+	ulong locals; /// number of local-counter pairs of the in-memory states
+	deque<Global_State_T<C>> memory;
+
+	std::FILE* file;
+	long read_pos, write_pos;   /// file offsets of the next block
+	deque<size_t> block_sizes;  /// sizes of the blocks in the file
+	string head, tail;          /// encoded states at the two ends
+	size_t head_pos;            /// next state in head
+
+	void flush_tail();
+	bool load_head();
+	void reclaim(const long& offset, const size_t& size);
+};
+
+} /* namespace sura */
+
+#endif /* STORE_HH_ */
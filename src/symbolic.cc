@@ -0,0 +1,296 @@
+/*
+ * symbolic.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "symbolic.hh"
+#include "fws.hh"
+
+#include <climits>
+#include <iomanip>
+#include <tuple>
+
+namespace sura {
+
+/**
+ * @brief compile the events of the model
+ * @param model
+ * @param init_ts
+ * @param n: number of threads at the initial states
+ * @param s: maximum number of spawn transition could be fired
+ */
+Symbolic::Symbolic(const Model& model, const Thread_State& init_ts,
+		const size_p& n, const size_p& s) :
+		model(model), init_ts(init_ts), n(n), s(s), mdd([&]() {
+			vector<uint> domains(model.L(), uint(n) + s + 1);
+			domains.emplace_back(uint(s) + 1);
+			domains.emplace_back(uint(model.S()));
+			return domains;
+		}()), by_top(mdd.levels() + 1), fire_cache(20), root(MDD::EMPTY), nfired(0) {
+	const int bound = int(n) + s;
+	std::map<std::tuple<Local_State, Local_State, bool>, uint> updates;
+	for (size_s sh = 0; sh < model.S(); ++sh) {
+		for (size_l l = 0; l < model.L(); ++l) {
+			for (const auto& e : model.successors(Thread_State(sh, l))) {
+				Event ev;
+				ev.top = this->share_level();
+				ev.update = updates.emplace(
+						std::make_tuple(l, e.dst.local, e.is_spawn),
+						updates.size()).first->second;
+				ev.f.resize(ev.top + 1);
+				ev.f[ev.top].assign(model.S(), -1);
+				ev.f[ev.top][sh] = e.dst.share;
+				if (e.is_spawn) { /// one spawn less
+					auto& f = ev.f[this->budget_level()];
+					for (int b = 0; b <= int(s); ++b)
+						f.emplace_back(b - 1);
+				}
+				auto& src = ev.f[this->counter_level(l)];
+				auto& dst = ev.f[this->counter_level(e.dst.local)];
+				src.resize(bound + 1);
+				dst.resize(bound + 1);
+				for (int i = 0; i <= bound; ++i) {
+					if (l == e.dst.local) /// stays at l, or spawns into l
+						src[i] = i == 0 ? -1 :
+									!e.is_spawn ? i : i < bound ? i + 1 : -1;
+					else {
+						src[i] = i == 0 ? -1 : e.is_spawn ? i : i - 1;
+						dst[i] = i < bound ? i + 1 : -1;
+					}
+				}
+				by_top[ev.top].emplace_back(E.size());
+				E.emplace_back(ev);
+			}
+		}
+	}
+}
+
+/**
+ * @brief compute the reachable global states: saturate the initial state
+ */
+void Symbolic::run() {
+	vector<uint> values(mdd.levels(), 0);
+	values[this->share_level() - 1] = init_ts.share;
+	values[this->budget_level() - 1] = s;
+	values[this->counter_level(init_ts.local) - 1] = n;
+	const Node_ID init = mdd.path(values);
+	mdd.protect(init);
+	root = this->saturate(init);
+	mdd.unprotect_node();
+	mdd.protect(root);
+	this->collect(); /// leaves the nodes of the reachable states only
+}
+
+/**
+ * @brief saturate p and, first, all nodes below it
+ * @param p
+ * @return Node_ID
+ */
+Node_ID Symbolic::saturate(const Node_ID& p) {
+	if (p == MDD::EMPTY || p == MDD::FULL)
+		return p;
+	const auto is = saturated.find(p);
+	if (is != saturated.end())
+		return is->second;
+	const uint k = mdd.level(p);
+	vector<Node_ID> r(mdd.domain(k), MDD::EMPTY);
+	mdd.protect(p);
+	mdd.protect(&r);
+	for (uint i = 0; i < r.size(); ++i)
+		r[i] = this->saturate(mdd.child(p, i));
+	const Node_ID result = this->close(k, r);
+	mdd.unprotect_buffer();
+	mdd.unprotect_node();
+	saturated.emplace(p, result);
+	return result;
+}
+
+/**
+ * @brief fire the events of top k on the node of the given children until
+ *        none adds a state. The children must be saturated and protected;
+ *        a union of saturated nodes is saturated, so they stay so. Only the
+ *        values whose child grew are fired again.
+ * @param k
+ * @param children
+ * @return Node_ID: the saturated node
+ */
+Node_ID Symbolic::close(const uint& k, vector<Node_ID>& children) {
+	if (by_top[k].empty())
+		return mdd.make(k, children);
+	vector<uint> queue;
+	vector<bool> queued(children.size(), false);
+	for (uint i = 0; i < children.size(); ++i)
+		if (children[i] != MDD::EMPTY)
+			queue.emplace_back(i), queued[i] = true;
+	while (!queue.empty()) {
+		const uint i = queue.back();
+		queue.pop_back();
+		queued[i] = false;
+		for (const auto& e : by_top[k]) {
+			const int j = E[e].f[k][i];
+			if (j < 0)
+				continue;
+			if (mdd.needs_collection())
+				this->collect();
+			const Node_ID g = this->fire(e, children[i]);
+			if (g == MDD::EMPTY)
+				continue;
+			const Node_ID u = mdd.unite(children[j], g);
+			if (u != children[j]) {
+				children[j] = u;
+				if (!queued[j])
+					queue.emplace_back(j), queued[j] = true;
+			}
+		}
+	}
+	return mdd.make(k, children);
+}
+
+/**
+ * @brief fire event e on the levels below its top: its image on q, a
+ *        saturated node, saturated. Below their top, events that update
+ *        the same counters in the same way share their cache entries.
+ * @param e
+ * @param q
+ * @return Node_ID
+ */
+Node_ID Symbolic::fire(const uint& e, const Node_ID& q) {
+	if (q == MDD::EMPTY || q == MDD::FULL)
+		return q;
+	const uint64_t key = (uint64_t(E[e].update) << 32) | q;
+	Node_ID result;
+	if (fire_cache.find(key, result))
+		return result;
+	++nfired;
+	const uint k = mdd.level(q);
+	const auto& f = E[e].f[k];
+	vector<Node_ID> r(mdd.domain(k), MDD::EMPTY);
+	mdd.protect(q);
+	mdd.protect(&r);
+	for (uint i = 0; i < r.size(); ++i) {
+		const int j = f.empty() ? int(i) : f[i];
+		if (j < 0 || mdd.child(q, i) == MDD::EMPTY)
+			continue;
+		const Node_ID g = this->fire(e, mdd.child(q, i));
+		if (g != MDD::EMPTY)
+			r[j] = mdd.unite(r[j], g);
+	}
+	result = this->close(k, r);
+	mdd.unprotect_buffer();
+	mdd.unprotect_node();
+	fire_cache.store(key, result);
+	return result;
+}
+
+/**
+ * @brief collect the garbage of the forest, and drop the caches that might
+ *        refer to it
+ */
+void Symbolic::collect() {
+	mdd.collect();
+	saturated.clear();
+	fire_cache.clear();
+}
+
+/**
+ * @brief the thread states of the reachable global states: (sh, l) is
+ *        reachable iff some path has shared state sh and counter l > 0. As
+ *        every node but EMPTY reaches FULL, it suffices to collect, bottom
+ *        up, the local states with a positive counter below every node.
+ * @return vector<vector<bool>>
+ */
+vector<vector<bool>> Symbolic::reachable_TS() {
+	vector<vector<bool>> R(model.S(), vector<bool>(model.L(), false));
+	if (root == MDD::EMPTY)
+		return R;
+	std::unordered_map<Node_ID, vector<bool>> positive; /// by node
+	positive.emplace(MDD::FULL, vector<bool>(model.L(), false));
+	vector<std::pair<Node_ID, uint>> stack;
+	for (size_s sh = 0; sh < model.S(); ++sh) {
+		const Node_ID p = mdd.child(root, sh);
+		if (p == MDD::EMPTY)
+			continue;
+		stack.emplace_back(p, 0);
+		while (!stack.empty()) { /// post order
+			auto& top = stack.back();
+			const Node_ID q = top.first;
+			const uint k = mdd.level(q);
+			if (top.second < mdd.domain(k)) {
+				const Node_ID c = mdd.child(q, top.second++);
+				if (c != MDD::EMPTY && positive.count(c) == 0)
+					stack.emplace_back(c, 0);
+				continue;
+			}
+			stack.pop_back();
+			if (positive.count(q) > 0)
+				continue;
+			vector<bool> ls(model.L(), false);
+			for (uint i = 0; i < mdd.domain(k); ++i) {
+				const Node_ID c = mdd.child(q, i);
+				if (c == MDD::EMPTY)
+					continue;
+				const auto& below = positive[c];
+				for (size_l l = 0; l < model.L(); ++l)
+					if (below[l])
+						ls[l] = true;
+				if (i > 0 && k < this->budget_level())
+					ls[k - 1] = true; /// k is counter_level(k - 1)
+			}
+			positive.emplace(q, std::move(ls));
+		}
+		R[sh] = positive[p];
+	}
+	return R;
+}
+
+long double Symbolic::states() {
+	return mdd.count(root);
+}
+
+/**
+ * @brief a symbolic forward search, see Symbolic. It stores no state one by
+ *        one, so it handles settings with astronomically many global states
+ *        as long as their MDD is small; it reaches the same thread states as
+ *        standard_FWS. The number of global states saturates at ULONG_MAX.
+ * @param n: number of threads at the initial states
+ * @param s: maximum number of spawn transition could be fired
+ * @return Search_Result
+ */
+Search_Result FWS::symbolic_FWS(const size_p& n, const size_p& s) {
+	Stopwatch watch;
+	vector<bool> reached;
+	this->begin_search(n, s, reached);
+	Symbolic sym(model, init_ts, n, s);
+	sym.run();
+
+	Search_Result result;
+	result.reachable = sym.reachable_TS();
+	result.reachable[init_ts.share][init_ts.local] = true;
+	const long double states = sym.states();
+	result.states = states < (long double) ULONG_MAX ? ulong(states) : ULONG_MAX;
+	result.mode = State_Store_Base::EXACT;
+	std::ostringstream summary;
+	summary << "symbolic: " << (result.states == ULONG_MAX ? "about " : "")
+			<< std::fixed << std::setprecision(0) << states
+			<< " global states, " << sym.forest().size() << " MDD nodes (peak "
+			<< sym.forest().peak() << "), " << sym.fired() << " firings, "
+			<< sym.forest().collections() << " collections";
+	result.summary = summary.str();
+	if (stats != nullptr) {
+		Search_Profile profile(n, s);
+		profile.time = watch.elapsed();
+		profile.states = result.states;
+		profile.edges = sym.fired();
+		profile.store = "mdd";
+		profile.counter = 0;
+		profile.bytes.emplace_back("mdd", sym.forest().bytes());
+		profile.bytes.emplace_back("TTD", model.bytes());
+		stats->add_phase("search", profile.time);
+		stats->add_search(profile);
+	}
+	return result;
+}
+
+} /* namespace sura */
@@ -0,0 +1,96 @@
+/*
+ * symbolic.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef SYMBOLIC_HH_
+#define SYMBOLIC_HH_
+
+#include "mdd.hh"
+#include "model.hh"
+
+namespace sura {
+
+/**
+ * @brief a symbolic forward search: the reachable global states as an MDD,
+ *        computed by saturation. The levels, from the bottom up: the counter
+ *        of every local state l (level 1 + l), the spawn budget (level
+ *        L + 1), and the shared state (level L + 2). Keeping the budget in a
+ *        level turns the bound on the threads into a local condition.
+ *        Every transition of the TTD is an event that updates the counters
+ *        of its source and destination, the budget if it spawns, and the
+ *        shared state. Saturation fires the events of top k on a node of
+ *        level k to a fixpoint, on children that are saturated already, and
+ *        fires a value again only if its child grew. Every event tests the
+ *        shared state, so with the shared state on top all events have the
+ *        same top, and it is the most selective test that comes first: with
+ *        it at the bottom, each firing ran through all counters to fail at
+ *        the last level, and the search was two orders of magnitude slower.
+ */
+class Symbolic {
+public:
+	Symbolic(const Model& model, const Thread_State& init_ts, const size_p& n,
+			const size_p& s);
+	~Symbolic() {
+	}
+
+	void run();
+
+	/// S x L: the reachable thread states
+	vector<vector<bool>> reachable_TS();
+	/// the reachable global states, as a long double: they can be more
+	/// than 2^64
+	long double states();
+
+	inline const MDD& forest() const {
+		return mdd;
+	}
+	inline ulong fired() const {
+		return nfired;
+	}
+	inline ulong events() const {
+		return E.size();
+	}
+
+private:
+	/// a transition, as its local function at every level it touches: the
+	/// new value of each value, or -1 if it is disabled there
+	struct Event {
+		uint top;
+		uint update;           /// the same for events equal below top
+		vector<vector<int>> f; /// by level 0 .. top, empty: untouched
+	};
+
+	const Model& model;
+	const Thread_State init_ts;
+	const size_p n;
+	const size_p s;
+	MDD mdd;
+	vector<Event> E;
+	vector<vector<uint>> by_top; /// events by their top level
+	std::unordered_map<Node_ID, Node_ID> saturated;
+	Op_Cache fire_cache;
+	Node_ID root;
+	ulong nfired;
+
+	inline uint counter_level(const Local_State& l) const {
+		return 1 + l;
+	}
+	inline uint budget_level() const {
+		return model.L() + 1;
+	}
+	inline uint share_level() const {
+		return model.L() + 2;
+	}
+
+	Node_ID saturate(const Node_ID& p);
+	Node_ID close(const uint& k, vector<Node_ID>& children);
+	Node_ID fire(const uint& e, const Node_ID& q);
+	void collect();
+};
+
+} /* namespace sura */
+
+#endif /* SYMBOLIC_HH_ */
@@ -0,0 +1,80 @@
+/*
+ * trace.cc
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#include "trace.hh"
+#include "fws.hh"
+
+namespace sura {
+
+const uint32_t Trace::NONE;
+
+Trace::Trace(const Model& model) :
+		model(model), init_ts(), n(0) {
+}
+
+/**
+ * @brief forget the last search, and record the initial state of the next
+ *        one as state 0
+ * @param init_ts
+ * @param n
+ */
+void Trace::begin(const Thread_State& init_ts, const size_p& n) {
+	this->init_ts = init_ts;
+	this->n = n;
+	parents.clear();
+	first.assign(model.S() * model.L(), NONE);
+	parents.emplace_back(NONE, NONE);
+	if (n > 0)
+		this->reach(init_ts, 0);
+}
+
+/**
+ * @brief is there a recorded path to target?
+ * @param target
+ * @return bool
+ */
+bool Trace::has_path(const Thread_State& target) const {
+	return model.contains(target) && first[model.index(target)] != NONE;
+}
+
+/**
+ * @brief print a shortest path from the initial state to a state with a
+ *        thread at target: the states on the path, and between two states
+ *        the transition taken
+ * @param target
+ * @param out
+ */
+void Trace::print_path(const Thread_State& target, ostream& out) const {
+	if (!this->has_path(target))
+		throw CONTROL::Error(
+				"no trace to " + std::to_string(target.share) + "|"
+						+ std::to_string(target.local));
+	vector<uint> edges;
+	for (uint32_t id = first[model.index(target)]; id != 0;
+			id = parents[id].first)
+		edges.emplace_back(parents[id].second);
+	std::reverse(edges.begin(), edges.end());
+
+	out << "Trace to " << target.share << "|" << target.local << " ("
+			<< edges.size() << " transitions):\n";
+	Global_State g(init_ts, n);
+	out << g << "\n";
+	for (const auto& id : edges) {
+		const auto src = model.edge_source(id);
+		const auto& e = model.edge(id);
+		if (src.share != g.share || g.locals.find(src.local) == g.locals.end())
+			throw CONTROL::Error("corrupt trace");
+		out << "  " << src << (e.is_spawn ? " +> " : " -> ") << e.dst << "\n";
+		g = Global_State(e.dst.share,
+				FWS::update_counter(g.locals, src.local, e.dst.local,
+						e.is_spawn));
+		out << g << "\n";
+	}
+	out << endl;
+}
+
+} /* namespace sura */
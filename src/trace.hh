@@ -0,0 +1,88 @@
+/*
+ * trace.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef TRACE_HH_
+#define TRACE_HH_
+
+#include <cstdint>
+
+#include "model.hh"
+
+namespace sura {
+
+/**
+ * @brief the parent pointers of a forward search. The search numbers its
+ *        states in the order it reaches them, the initial state 0, and
+ *        records for every new state the number of its parent and the id
+ *        of the transition from the parent: 8 bytes per state. It also
+ *        records the first state that reaches every thread state, 4 bytes
+ *        per thread state. Numbers are 32 bits: after 2^32 - 1 states the
+ *        trace stops recording, so it never takes more than 32 GB, and
+ *        thread states first reached later have no path. The search is
+ *        breadth first, so following the parents from the first state that
+ *        reaches a thread state gives a shortest path to it; replaying the
+ *        transitions from the initial state gives the states on the path.
+ */
+class Trace {
+public:
+	/// no state
+	static const uint32_t NONE = UINT32_MAX;
+
+	explicit Trace(const Model& model);
+	~Trace() {
+	}
+
+	void begin(const Thread_State& init_ts, const size_p& n);
+
+	/**
+	 * @brief record a new state
+	 * @param parent: the number of its parent
+	 * @param edge  : the id of the transition from the parent, see
+	 *                Model::edge_id
+	 * @return the number of the new state, or NONE if the trace is full
+	 */
+	inline uint32_t add(const ulong& parent, const uint& edge) {
+		if (parents.size() >= NONE)
+			return NONE;
+		parents.emplace_back(uint32_t(parent), edge);
+		return parents.size() - 1;
+	}
+
+	/// state id, unless NONE, has a thread at t
+	inline void reach(const Thread_State& t, const uint32_t& id) {
+		auto& f = first[model.index(t)];
+		if (f == NONE)
+			f = id;
+	}
+
+	bool has_path(const Thread_State& target) const;
+	void print_path(const Thread_State& target, ostream& out = cout) const;
+
+	/// the states recorded
+	inline ulong size() const {
+		return parents.size();
+	}
+	/// the trace stopped recording, see add
+	inline bool is_full() const {
+		return parents.size() >= NONE;
+	}
+	inline ulong bytes() const {
+		return parents.capacity() * sizeof(parents[0])
+				+ first.size() * sizeof(uint32_t);
+	}
+
+private:
+	const Model& model;
+	Thread_State init_ts;
+	size_p n;
+	vector<std::pair<uint32_t, uint32_t>> parents; /// (parent, transition)
+	vector<uint32_t> first; /// by Model::index: the first state reaching it
+};
+
+} /* namespace sura */
+
+#endif /* TRACE_HH_ */
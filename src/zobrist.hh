@@ -0,0 +1,116 @@
+/*
+ * zobrist.hh
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lpzun
+ */
+
+#ifndef ZOBRIST_HH_
+#define ZOBRIST_HH_
+
+#include "state.hh"
+
+namespace sura {
+
+template<class C, size_l N> struct Dense_State;
+
+/**
+ * @brief Zobrist hashing of global states. The hash of a state is the XOR of
+ *        a random key of its shared state and a random key of every pair
+ *        (local state, counter) with a nonzero counter. A transition changes
+ *        the shared state and at most two counters, so the hash of a
+ *        successor follows from the hash of its parent by a few XORs.
+ *        The keys of (local, counter) come from a table if it is small
+ *        enough, for counters up to the bound of the search, and are mixed
+ *        on the fly otherwise.
+ */
+class Zobrist {
+public:
+	/// the largest table of (local, counter) keys
+	static const ulong MAX_TABLE = 1 << 20;
+
+	Zobrist(const size_s& S, const size_l& L, culong& bound) :
+			bound(bound), zs(S) {
+		uint64_t seed = 0x2545f4914f6cdd1dULL;
+		for (auto& k : zs)
+			k = mix(seed++);
+		if (ulong(L) * (bound + 1) <= MAX_TABLE) {
+			zl.resize(ulong(L) * (bound + 1));
+			for (auto& k : zl)
+				k = mix(seed++);
+		}
+	}
+
+	inline uint64_t shared(const Shared_State& s) const {
+		return zs[s];
+	}
+
+	inline uint64_t local(const Local_State& l, culong& c) const {
+		if (c == 0)
+			return 0;
+		if (!zl.empty())
+			return zl[l * (bound + 1) + c];
+		return mix((uint64_t(l) << 32) ^ c);
+	}
+
+	/**
+	 * @brief the hash of a successor: a thread moves from local dec to inc,
+	 *        or, if is_spawn, a thread is spawned at inc; the shared state
+	 *        changes from s to _s
+	 * @param h    : the hash of the parent
+	 * @param s    : the shared state of the parent
+	 * @param _s   : the shared state of the successor
+	 * @param dec  : the local state the thread leaves
+	 * @param c_dec: the counter of dec in the parent
+	 * @param inc  : the local state the thread enters
+	 * @param c_inc: the counter of inc in the parent
+	 * @param is_spawn
+	 * @return uint64_t
+	 */
+	inline uint64_t successor(const uint64_t& h, const Shared_State& s,
+			const Shared_State& _s, const Local_State& dec, culong& c_dec,
+			const Local_State& inc, culong& c_inc, const bool& is_spawn) const {
+		uint64_t _h = h ^ zs[s] ^ zs[_s];
+		if (is_spawn)
+			return _h ^ local(inc, c_inc) ^ local(inc, c_inc + 1);
+		if (dec == inc)
+			return _h;
+		return _h ^ local(dec, c_dec) ^ local(dec, c_dec - 1)
+				^ local(inc, c_inc) ^ local(inc, c_inc + 1);
+	}
+
+	/// the hash of a sparse state, from scratch
+	template<class C>
+	uint64_t hash(const Global_State_T<C>& g) const {
+		uint64_t h = zs[g.share];
+		for (const auto& p : g.locals)
+			h ^= local(p.first, p.second);
+		return h;
+	}
+
+	/// the hash of a dense state, from scratch
+	template<class C, size_l N>
+	uint64_t hash(const Dense_State<C, N>& g) const {
+		uint64_t h = zs[g.share];
+		for (size_l l = 0; l < N; ++l)
+			h ^= local(l, g.counters[l]);
+		return h;
+	}
+
+private:
+	ulong bound;
+	vector<uint64_t> zs; /// keys of shared states
+	vector<uint64_t> zl; /// keys of (local, counter), if tabled
+
+	/// splitmix64 finalizer
+	static inline uint64_t mix(uint64_t x) {
+		x += 0x9e3779b97f4a7c15ULL;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+		return x ^ (x >> 31);
+	}
+};
+
+} /* namespace sura */
+
+#endif /* ZOBRIST_HH_ */